@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cgx::sch {
+
+// Fixed buffer from which callback closures are constructed back to back.
+// bind() returns a one-pointer handle that std::function keeps in its small
+// buffer, so tasks and stages built from it never touch the heap.
+//
+// reset() destroys every closure at once; only call it once the tasks and
+// stages using them are gone.
+template <std::size_t Bytes>
+class arena_t {
+   public:
+    template <typename F>
+    class ref_t {
+       public:
+        template <typename... Args>
+        decltype(auto) operator()(Args&&... args) const {
+            return (*m_f)(std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return m_f != nullptr; }
+
+        explicit ref_t(F* f) : m_f(f) {}
+
+       private:
+        F* m_f;
+    };
+
+    // Returns an empty handle if the closure does not fit.
+    template <typename F>
+    ref_t<std::decay_t<F>> bind(F&& f) {
+        using T          = std::decay_t<F>;
+        const auto start = _align(m_used, alignof(header_t));
+        const auto obj   = _align(start + sizeof(header_t), alignof(T));
+        const auto end   = obj + sizeof(T);
+        if (end > Bytes) {
+            return ref_t<T>(nullptr);
+        }
+        new (m_buffer + start)
+            header_t{[](void* p) { static_cast<T*>(p)->~T(); }, obj, end};
+        auto* ptr = new (m_buffer + obj) T(std::forward<F>(f));
+        m_used    = end;
+        return ref_t<T>(ptr);
+    }
+
+    void reset() {
+        std::size_t pos{0};
+        while (pos < m_used) {
+            pos          = _align(pos, alignof(header_t));
+            auto* header = std::launder(
+                reinterpret_cast<header_t*>(m_buffer + pos));
+            header->dtor(m_buffer + header->obj);
+            pos = header->end;
+        }
+        m_used = 0;
+    }
+
+    std::size_t used() const { return m_used; }
+    std::size_t capacity() const { return Bytes; }
+
+    arena_t() = default;
+    ~arena_t() { reset(); }
+    arena_t(const arena_t&) = delete;
+    arena_t& operator=(const arena_t&) = delete;
+
+   private:
+    struct header_t {
+        void (*dtor)(void*);
+        std::size_t obj;
+        std::size_t end;
+    };
+
+    alignas(std::max_align_t) std::byte m_buffer[Bytes];
+    std::size_t m_used{0};
+
+    // Offset of the first address at or after m_buffer + pos aligned to
+    // align; closures may be aligned beyond the buffer's own alignment.
+    std::size_t _align(const std::size_t pos, const std::size_t align) const {
+        const auto address = reinterpret_cast<std::uintptr_t>(m_buffer) + pos;
+        return pos + (align - address % align) % align;
+    }
+};
+
+}  // namespace cgx::sch
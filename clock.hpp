@@ -0,0 +1,179 @@
+#pragma once
+
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#include "inner.hpp"
+
+// Ready-made now() sources for scheduler_t. Hz is the scheduler tick rate and
+// defaults to SCH_TICK_HZ, which std::chrono periods and sleeps assume;
+// conversions from nanoseconds are folded at compile time.
+//
+// Measured by tools/clock_bench on an x86-64 Linux VM (vDSO, no syscall);
+// rerun it on the target, virtualization changes these a lot:
+//   monotonic_clock_t         ~41 ns/read, ~33 ns steps (read-cost bound)
+//   monotonic_coarse_clock_t  ~10 ns/read, 4 ms steps (jiffy)
+//   tsc_clock_t               ~24 ns/read, ~18 ns steps (read-cost bound)
+//   cached_clock_t             ~2 ns/read, steps of the ticker period
+namespace cgx::sch {
+
+namespace inner {
+
+template <std::uint64_t Hz>
+constexpr timer_t::time_t ns_to_ticks(const std::uint64_t sec,
+                                      const std::uint64_t nsec) {
+    static_assert(Hz > 0 && Hz <= 1000000000, "Hz must be in (0, 1 GHz]");
+    if constexpr (1000000000 % Hz == 0) {
+        return sec * Hz + nsec / (1000000000 / Hz);
+    } else {
+        return sec * Hz + nsec * Hz / 1000000000;
+    }
+}
+
+template <std::uint64_t Hz>
+timer_t::time_t read_clock(const clockid_t id) {
+    timespec ts{};
+    clock_gettime(id, &ts);
+    return ns_to_ticks<Hz>(static_cast<std::uint64_t>(ts.tv_sec),
+                           static_cast<std::uint64_t>(ts.tv_nsec));
+}
+
+}  // namespace inner
+
+template <std::uint64_t Hz = SCH_TICK_HZ>
+struct monotonic_clock_t {
+    inner::timer_t::time_t operator()() const {
+        return inner::read_clock<Hz>(CLOCK_MONOTONIC);
+    }
+};
+
+#if defined(CLOCK_MONOTONIC_COARSE)
+// Only suitable when the tick period is well above the kernel jiffy.
+template <std::uint64_t Hz = SCH_TICK_HZ>
+struct monotonic_coarse_clock_t {
+    inner::timer_t::time_t operator()() const {
+        return inner::read_clock<Hz>(CLOCK_MONOTONIC_COARSE);
+    }
+};
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+// Reads the TSC and scales it with a fixed-point factor calibrated against
+// CLOCK_MONOTONIC at construction. Only meaningful when is_invariant().
+template <std::uint64_t Hz = SCH_TICK_HZ>
+class tsc_clock_t {
+   public:
+    inner::timer_t::time_t operator()() const {
+        const auto tsc = static_cast<u128_t>(__rdtsc() - m_tsc0);
+        return m_ticks0 +
+               static_cast<inner::timer_t::time_t>((tsc * m_mult) >> shift);
+    }
+
+    static bool is_invariant() {
+        unsigned eax{0}, ebx{0}, ecx{0}, edx{0};
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (edx & (1U << 8)) != 0;
+    }
+
+    explicit tsc_clock_t(const std::chrono::milliseconds calibration =
+                             std::chrono::milliseconds(20)) {
+        const auto ns0  = inner::read_clock<1000000000>(CLOCK_MONOTONIC);
+        const auto tsc0 = __rdtsc();
+        std::this_thread::sleep_for(calibration);
+        const auto ns1  = inner::read_clock<1000000000>(CLOCK_MONOTONIC);
+        const auto tsc1 = __rdtsc();
+
+        // ticks per tsc cycle, in 2^-shift units.
+        const auto ticks = static_cast<u128_t>(ns1 - ns0) * Hz;
+        m_mult = static_cast<std::uint64_t>(
+            (ticks << shift) /
+            (static_cast<u128_t>(tsc1 - tsc0) * 1000000000));
+        m_tsc0   = tsc1;
+        m_ticks0 = inner::ns_to_ticks<Hz>(ns1 / 1000000000, ns1 % 1000000000);
+    }
+
+   private:
+    // __extension__ keeps -Wpedantic quiet about the GNU 128-bit type.
+    __extension__ typedef unsigned __int128 u128_t;
+
+    static constexpr unsigned shift = 48;
+
+    std::uint64_t          m_mult{0};
+    std::uint64_t          m_tsc0{0};
+    inner::timer_t::time_t m_ticks0{0};
+};
+#endif
+
+// A ticker thread refreshes a shared tick counter from CLOCK_MONOTONIC;
+// reads are a single relaxed load. Pass reader() to scheduler_t.
+template <std::uint64_t Hz = SCH_TICK_HZ>
+class cached_clock_t {
+   public:
+    class reader_t {
+       public:
+        inner::timer_t::time_t operator()() const {
+            return m_now->load(std::memory_order_relaxed);
+        }
+        explicit reader_t(const std::atomic<inner::timer_t::time_t>& now)
+            : m_now(&now) {}
+
+       private:
+        const std::atomic<inner::timer_t::time_t>* m_now;
+    };
+
+    reader_t reader() const { return reader_t(m_now); }
+
+    inner::timer_t::time_t operator()() const {
+        return m_now.load(std::memory_order_relaxed);
+    }
+
+    explicit cached_clock_t(const std::chrono::nanoseconds update_period =
+                                std::chrono::nanoseconds(1000000000 / Hz)) {
+        m_now = inner::read_clock<Hz>(CLOCK_MONOTONIC);
+        m_ticker = std::thread([this, update_period] {
+            while (m_running.load(std::memory_order_relaxed)) {
+                m_now.store(inner::read_clock<Hz>(CLOCK_MONOTONIC),
+                            std::memory_order_relaxed);
+                std::this_thread::sleep_for(update_period);
+            }
+        });
+    }
+    ~cached_clock_t() {
+        m_running = false;
+        m_ticker.join();
+    }
+    cached_clock_t(const cached_clock_t&) = delete;
+    cached_clock_t& operator=(const cached_clock_t&) = delete;
+
+   private:
+    std::atomic<inner::timer_t::time_t> m_now{0};
+    std::atomic<bool>                   m_running{true};
+    std::thread                         m_ticker;
+};
+
+// Average cost of one read of clock, in nanoseconds.
+template <typename C>
+double read_cost_ns(const C& clock, const std::size_t iterations = 1000000) {
+    volatile inner::timer_t::time_t sink{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        sink = clock();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           static_cast<double>(iterations);
+}
+
+}  // namespace cgx::sch
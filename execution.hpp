@@ -0,0 +1,110 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "scheduler.hpp"
+
+// Sender/receiver adapter (P2300 shape) for thread_t.
+//
+// schedule(thread) and schedule_after(thread, ticks) return senders whose
+// operation completes with set_value() from inside thread's run(). Operation
+// states are intrusive and non-movable: connect() constructs them in place in
+// the caller's frame, and nothing is allocated.
+//
+// Receivers provide an rvalue set_value() member.
+namespace cgx::sch::exec {
+
+template <typename R>
+class operation_t : private inner::oneshot_t {
+   public:
+    void start() noexcept {
+        if (m_delay > 0) {
+            this->at = inner::timer_t::instance().make_deadline(
+                static_cast<inner::timer_t::time_t>(m_delay));
+        }
+        m_thread->post(this);
+    }
+
+    template <typename Rx>
+    operation_t(thread_t* thread, const inner::timer_t::duration_t delay,
+                Rx&& receiver)
+        : m_receiver(std::forward<Rx>(receiver)),
+          m_thread(thread),
+          m_delay(delay) {
+        this->fn = &operation_t::_complete;
+    }
+    operation_t(const operation_t&) = delete;
+    operation_t& operator=(const operation_t&) = delete;
+    operation_t(operation_t&&) = delete;
+    operation_t& operator=(operation_t&&) = delete;
+
+   private:
+    R                          m_receiver;
+    thread_t*                  m_thread;
+    inner::timer_t::duration_t m_delay;
+
+    static void _complete(inner::oneshot_t* self) {
+        auto* op = static_cast<operation_t*>(self);
+        std::move(op->m_receiver).set_value();
+    }
+};
+
+class sender_t {
+   public:
+    template <typename R>
+    operation_t<std::decay_t<R>> connect(R&& receiver) const {
+        return operation_t<std::decay_t<R>>(m_thread, m_delay,
+                                            std::forward<R>(receiver));
+    }
+
+    sender_t(thread_t* thread, const inner::timer_t::duration_t delay = 0)
+        : m_thread(thread), m_delay(delay) {}
+
+   private:
+    thread_t*                  m_thread;
+    inner::timer_t::duration_t m_delay;
+};
+
+class scheduler_t {
+   public:
+    sender_t schedule() const { return sender_t(m_thread); }
+    sender_t schedule_after(const inner::timer_t::duration_t ticks) const {
+        return sender_t(m_thread, ticks);
+    }
+
+    bool operator==(const scheduler_t& other) const {
+        return m_thread == other.m_thread;
+    }
+    bool operator!=(const scheduler_t& other) const {
+        return !(*this == other);
+    }
+
+    explicit scheduler_t(thread_t& thread) : m_thread(&thread) {}
+
+   private:
+    thread_t* m_thread;
+};
+
+inline scheduler_t get_scheduler(thread_t& thread) {
+    return scheduler_t(thread);
+}
+
+inline sender_t schedule(thread_t& thread) { return sender_t(&thread); }
+
+inline sender_t schedule_after(thread_t&                        thread,
+                               const inner::timer_t::duration_t ticks) {
+    return sender_t(&thread, ticks);
+}
+
+template <typename S, typename R>
+auto connect(S&& sender, R&& receiver) {
+    return std::forward<S>(sender).connect(std::forward<R>(receiver));
+}
+
+template <typename O>
+void start(O& op) noexcept {
+    op.start();
+}
+
+}  // namespace cgx::sch::exec
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "inner.hpp"
+
+namespace cgx::sch {
+
+// Test-mode stress for task callbacks and the scheduler clock.
+//
+// wrap() adds occasional overruns and long stalls to a callback; wrap_clock()
+// adds occasional forward or backward jumps to a now() source. When the clock
+// is wrapped and busy is false, overruns and stalls advance the wrapped
+// clock instead of spinning, so runs are fast and reproducible from seed.
+//
+// The wrapped clock is shared by every scheduler thread, so the generator,
+// the offset and the counters are atomic. With several threads the draws
+// are interleaved, and only single-threaded runs repeat exactly.
+class fault_injector_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+
+    struct options_t {
+        double        overrun_probability{0.0};
+        duration_t    overrun_ticks{0};
+        double        stall_probability{0.0};
+        duration_t    stall_ticks{0};
+        double        jump_probability{0.0};
+        duration_t    jump_ticks{0};
+        bool          busy{false};
+        std::uint64_t seed{1};
+    };
+
+    std::function<time_t()> wrap_clock(std::function<time_t()> source) {
+        m_is_clock_wrapped = true;
+        return [this, source] {
+            if (_roll(m_options.jump_probability)) {
+                m_offset.fetch_add(m_options.jump_ticks,
+                                   std::memory_order_relaxed);
+                m_jumps.fetch_add(1, std::memory_order_relaxed);
+            }
+            const auto now = static_cast<duration_t>(source()) +
+                             m_offset.load(std::memory_order_relaxed);
+            return static_cast<time_t>(now > 0 ? now : 0);
+        };
+    }
+
+    std::function<bool()> wrap(std::function<bool()> callback) {
+        return [this, callback] {
+            if (_roll(m_options.stall_probability)) {
+                m_stalls.fetch_add(1, std::memory_order_relaxed);
+                _delay(m_options.stall_ticks);
+            } else if (_roll(m_options.overrun_probability)) {
+                m_overruns.fetch_add(1, std::memory_order_relaxed);
+                _delay(m_options.overrun_ticks);
+            }
+            return callback();
+        };
+    }
+
+    std::uint32_t overruns() const { return m_overruns.load(); }
+    std::uint32_t stalls() const { return m_stalls.load(); }
+    std::uint32_t jumps() const { return m_jumps.load(); }
+
+    fault_injector_t(const options_t& options)
+        : m_options(options), m_state(options.seed | 1) {}
+
+   private:
+    options_t                  m_options;
+    std::atomic<std::uint64_t> m_state;
+    std::atomic<duration_t>    m_offset{0};
+    std::atomic<bool>          m_is_clock_wrapped{false};
+    std::atomic<std::uint32_t> m_overruns{0};
+    std::atomic<std::uint32_t> m_stalls{0};
+    std::atomic<std::uint32_t> m_jumps{0};
+
+    bool _roll(const double probability) {
+        if (probability <= 0.0) {
+            return false;
+        }
+        std::uint64_t state = m_state.load(std::memory_order_relaxed);
+        std::uint64_t next{0};
+        do {
+            next = state;
+            next ^= next << 13;
+            next ^= next >> 7;
+            next ^= next << 17;
+        } while (!m_state.compare_exchange_weak(state, next,
+                                                std::memory_order_relaxed));
+        return static_cast<double>(next >> 11) * 0x1.0p-53 < probability;
+    }
+
+    void _delay(const duration_t ticks) {
+        if (m_is_clock_wrapped && !m_options.busy) {
+            m_offset.fetch_add(ticks, std::memory_order_relaxed);
+            return;
+        }
+        auto&      timer = inner::timer_t::instance();
+        const auto start = timer.now();
+        while (timer.elapsed(start) < ticks) {
+        }
+    }
+};
+
+}  // namespace cgx::sch
@@ -1,10 +1,21 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <limits>
 
+// Rate of the now() source given to scheduler_t, in ticks per second. Only
+// used to convert std::chrono durations to ticks.
+#ifndef SCH_TICK_HZ
+#define SCH_TICK_HZ 1000
+#endif
+
+#ifndef SCH_THREAD_LOCAL
+#define SCH_THREAD_LOCAL thread_local
+#endif
+
 namespace cgx::sch {
 namespace inner {
 
@@ -46,6 +57,81 @@ class timer_t {
     timer_t& operator=(timer_t&&) = delete;
 };
 
+using tick_t = std::chrono::duration<timer_t::duration_t,
+                                     std::ratio<1, SCH_TICK_HZ>>;
+
+// Rounds up, so a period or sleep is never shorter than asked. The ratio
+// arithmetic is resolved at compile time; for a constant d the result is too.
+template <typename Rep, typename Period>
+constexpr timer_t::duration_t to_ticks(
+    const std::chrono::duration<Rep, Period> d) {
+    return std::chrono::ceil<tick_t>(d).count();
+}
+
+inline void prefetch(const void* addr) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr);
+#else
+    (void)addr;
+#endif
+}
+
+// Intrusive node for one-shot work posted to a thread, see thread_t::post().
+struct oneshot_t {
+    oneshot_t*      next{nullptr};
+    timer_t::time_t at{0};
+    void (*fn)(oneshot_t*){nullptr};
+};
+
+class dispatch_t {
+   public:
+    class disposable_dispatch_t {
+       public:
+        disposable_dispatch_t(dispatch_t& d, const char* name)
+            : m_d(d), m_prev(d.m_task_name), m_prev_wake(d.m_wake_tick) {
+            m_d.m_task_name = name;
+            m_d.m_wake_tick = 0;
+        }
+        ~disposable_dispatch_t() {
+            m_d.m_task_name = m_prev;
+            m_d.m_wake_tick = m_prev_wake;
+        }
+
+       private:
+        dispatch_t&     m_d;
+        const char*     m_prev;
+        timer_t::time_t m_prev_wake;
+    };
+
+    disposable_dispatch_t mark(const char* name) {
+        return disposable_dispatch_t(*this, name);
+    }
+
+    const char* task_name() const { return m_task_name; }
+
+    // Lets code running inside a callback tell its task that it has
+    // nothing to do before the given tick. The earliest request wins.
+    void wake_at(const timer_t::time_t tick) {
+        if (m_wake_tick == 0 || tick < m_wake_tick) {
+            m_wake_tick = tick;
+        }
+    }
+    timer_t::time_t wake_tick() const { return m_wake_tick; }
+
+    static dispatch_t& instance() {
+        static SCH_THREAD_LOCAL dispatch_t instance;
+        return instance;
+    }
+
+   private:
+    const char*     m_task_name{nullptr};
+    timer_t::time_t m_wake_tick{0};
+
+    dispatch_t() = default;
+    dispatch_t(const dispatch_t&) = delete;
+    dispatch_t& operator=(const dispatch_t&) = delete;
+};
+
 template <typename T, std::size_t N = 32>
 class min_max_mean_t {
    public:
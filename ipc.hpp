@@ -0,0 +1,251 @@
+#pragma once
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "scheduler.hpp"
+
+namespace cgx::sch::ipc {
+
+struct command_t {
+    enum class type_t : std::uint8_t {
+        notify,
+        start,
+        stop,
+        pkill,
+    };
+
+    type_t       type{type_t::notify};
+    char         name[9]{};
+    std::int64_t delay{0};
+
+    static command_t make(const type_t type, const char* name,
+                          const std::int64_t delay = 0) {
+        command_t cmd;
+        cmd.type       = type;
+        const auto len = std::strlen(name);
+        std::memcpy(cmd.name, name, len > 8 ? 8 : len);
+        cmd.delay = delay;
+        return cmd;
+    }
+};
+
+// Bounded multi-producer queue living in a POSIX shared memory object.
+// Producers in any process push commands; the scheduler process drains them
+// into its scheduler_t, typically from thread<N>::set_poll_cb().
+template <std::size_t N = 256>
+class command_queue_t {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+   public:
+    // Replaces any object left under name by a previous run; producers
+    // that still map it must open() again.
+    static command_queue_t create(const char* name) {
+        shm_unlink(name);
+        const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0660);
+        if (fd < 0) {
+            return {};
+        }
+        if (ftruncate(fd, sizeof(layout_t)) != 0) {
+            close(fd);
+            return {};
+        }
+        auto* layout = _map(fd);
+        if (layout == nullptr) {
+            return {};
+        }
+        for (std::size_t i = 0; i < N; i++) {
+            layout->cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+        layout->head.store(0, std::memory_order_relaxed);
+        layout->tail.store(0, std::memory_order_relaxed);
+        layout->magic.store(magic, std::memory_order_release);
+        return command_queue_t(layout);
+    }
+
+    static command_queue_t open(const char* name) {
+        const int fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) {
+            return {};
+        }
+        auto* layout = _map(fd);
+        if (layout == nullptr) {
+            return {};
+        }
+        if (layout->magic.load(std::memory_order_acquire) != magic) {
+            munmap(layout, sizeof(layout_t));
+            return {};
+        }
+        return command_queue_t(layout);
+    }
+
+    static bool unlink(const char* name) { return shm_unlink(name) == 0; }
+
+    bool push(const command_t& cmd) {
+        auto pos = m_layout->head.load(std::memory_order_relaxed);
+        while (true) {
+            auto&      cell = m_layout->cells[pos & (N - 1)];
+            const auto seq  = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - pos);
+            if (diff == 0) {
+                if (m_layout->head.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.cmd = cmd;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_layout->head.load(std::memory_order_relaxed);
+            }
+        }
+
+        // seq_cst pairs with wait(): either this load sees the waiter, or
+        // the waiter's FUTEX_WAIT sees the new futex value and returns.
+        m_layout->futex.fetch_add(1, std::memory_order_seq_cst);
+        if (m_layout->waiters.load(std::memory_order_seq_cst) > 0) {
+            syscall(SYS_futex, &m_layout->futex, FUTEX_WAKE, 1, nullptr,
+                    nullptr, 0);
+        }
+        return true;
+    }
+
+    // Single consumer.
+    bool pop(command_t& cmd) {
+        const auto pos  = m_layout->tail.load(std::memory_order_relaxed);
+        auto&      cell = m_layout->cells[pos & (N - 1)];
+        const auto seq  = cell.seq.load(std::memory_order_acquire);
+        if (seq != pos + 1) {
+            return false;
+        }
+        cmd = cell.cmd;
+        cell.seq.store(pos + N, std::memory_order_release);
+        m_layout->tail.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::size_t drain(scheduler_t& scheduler) {
+        std::size_t count{0};
+        command_t   cmd;
+        while (pop(cmd)) {
+            switch (cmd.type) {
+                case command_t::type_t::notify:
+                    scheduler.notify(cmd.name, cmd.delay);
+                    break;
+                case command_t::type_t::start:
+                    scheduler.start(cmd.name);
+                    break;
+                case command_t::type_t::stop:
+                    scheduler.stop(cmd.name);
+                    break;
+                case command_t::type_t::pkill:
+                    scheduler.pkill(cmd.name);
+                    break;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    // Blocks the consumer until a command is pushed or timeout_ms elapses.
+    void wait(const std::uint32_t timeout_ms) {
+        const auto seq = m_layout->futex.load(std::memory_order_acquire);
+        m_layout->waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (!_has_pending()) {
+            timespec timeout{};
+            timeout.tv_sec  = timeout_ms / 1000;
+            timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000;
+            syscall(SYS_futex, &m_layout->futex, FUTEX_WAIT, seq, &timeout,
+                    nullptr, 0);
+        }
+        m_layout->waiters.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    bool notify(const char* name) {
+        return push(command_t::make(command_t::type_t::notify, name));
+    }
+    bool call_later(const char* name, const std::int64_t delay) {
+        return push(command_t::make(command_t::type_t::notify, name, delay));
+    }
+    bool start(const char* name) {
+        return push(command_t::make(command_t::type_t::start, name));
+    }
+    bool stop(const char* name) {
+        return push(command_t::make(command_t::type_t::stop, name));
+    }
+
+    explicit operator bool() const { return m_layout != nullptr; }
+
+    command_queue_t() = default;
+    command_queue_t(command_queue_t&& other) noexcept
+        : m_layout(std::exchange(other.m_layout, nullptr)) {}
+    command_queue_t& operator=(command_queue_t&& other) noexcept {
+        if (this != &other) {
+            _unmap();
+            m_layout = std::exchange(other.m_layout, nullptr);
+        }
+        return *this;
+    }
+    command_queue_t(const command_queue_t&) = delete;
+    command_queue_t& operator=(const command_queue_t&) = delete;
+    ~command_queue_t() { _unmap(); }
+
+   private:
+    static constexpr std::uint32_t magic = 0x53434851;  // "SCHQ"
+
+    struct cell_t {
+        std::atomic<std::uint64_t> seq;
+        command_t                  cmd;
+    };
+
+    struct layout_t {
+        std::atomic<std::uint32_t>             magic;
+        alignas(64) std::atomic<std::uint64_t> head;
+        alignas(64) std::atomic<std::uint64_t> tail;
+        alignas(64) std::atomic<std::uint32_t> futex;
+        std::atomic<std::uint32_t>             waiters;
+        alignas(64) cell_t                     cells[N];
+    };
+
+    layout_t* m_layout{nullptr};
+
+    explicit command_queue_t(layout_t* layout) : m_layout(layout) {}
+
+    static layout_t* _map(const int fd) {
+        void* addr = mmap(nullptr, sizeof(layout_t), PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED) {
+            return nullptr;
+        }
+        return static_cast<layout_t*>(addr);
+    }
+
+    void _unmap() {
+        if (m_layout != nullptr) {
+            munmap(m_layout, sizeof(layout_t));
+            m_layout = nullptr;
+        }
+    }
+
+    bool _has_pending() const {
+        const auto pos = m_layout->tail.load(std::memory_order_relaxed);
+        return m_layout->cells[pos & (N - 1)].seq.load(
+                   std::memory_order_acquire) == pos + 1;
+    }
+};
+
+}  // namespace cgx::sch::ipc
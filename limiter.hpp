@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "inner.hpp"
+
+namespace cgx::sch {
+
+// Token bucket refilled by one token every refill_ticks. Refill is computed
+// lazily from the elapsed ticks whenever the bucket is queried.
+class rate_limiter_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+
+    bool available(const std::uint32_t tokens = 1) const {
+        _refill();
+        return m_tokens >= tokens;
+    }
+
+    bool try_acquire(const std::uint32_t tokens = 1) {
+        _refill();
+        if (m_tokens < tokens) {
+            return false;
+        }
+        m_tokens -= tokens;
+        return true;
+    }
+
+    duration_t ticks_until_available() const {
+        _refill();
+        if (m_tokens > 0) {
+            return 0;
+        }
+        return m_refill_ticks - m_timer.elapsed(m_last_refill);
+    }
+
+    std::uint32_t tokens() const {
+        _refill();
+        return m_tokens;
+    }
+
+    rate_limiter_t(const std::uint32_t capacity, const duration_t refill_ticks)
+        : m_capacity(capacity),
+          m_refill_ticks(refill_ticks > 0 ? refill_ticks : 1),
+          m_tokens(capacity),
+          m_last_refill(m_timer.now()) {}
+
+   private:
+    inner::timer_t&       m_timer{inner::timer_t::instance()};
+    std::uint32_t         m_capacity;
+    duration_t            m_refill_ticks;
+    mutable std::uint32_t m_tokens;
+    mutable time_t        m_last_refill;
+
+    void _refill() const {
+        // A full bucket does not accrue: the next token is due refill_ticks
+        // after the first one is taken, so bursts never exceed capacity.
+        if (m_tokens >= m_capacity) {
+            m_last_refill = m_timer.now();
+            return;
+        }
+        const auto elapsed = m_timer.elapsed(m_last_refill);
+        if (elapsed < m_refill_ticks) {
+            return;
+        }
+        const auto count = elapsed / m_refill_ticks;
+        if (count >= static_cast<duration_t>(m_capacity - m_tokens)) {
+            m_tokens      = m_capacity;
+            m_last_refill = m_timer.now();
+            return;
+        }
+        m_tokens += static_cast<std::uint32_t>(count);
+        m_last_refill += static_cast<time_t>(count * m_refill_ticks);
+    }
+};
+
+// Lets a call through at most once every interval ticks (leading edge).
+class throttle_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+
+    bool ready() const {
+        return !m_has_passed || m_timer.elapsed(m_last) >= m_interval;
+    }
+
+    bool operator()() {
+        if (!ready()) {
+            return false;
+        }
+        m_last       = m_timer.now();
+        m_has_passed = true;
+        return true;
+    }
+
+    throttle_t(const duration_t interval) : m_interval(interval) {}
+
+   private:
+    inner::timer_t& m_timer{inner::timer_t::instance()};
+    duration_t      m_interval;
+    time_t          m_last{0};
+    bool            m_has_passed{false};
+};
+
+// Follows an input signal once it has held the same value for ticks.
+class debounce_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+
+    bool operator()(const bool input) {
+        if (input != m_candidate) {
+            m_candidate = input;
+            m_since     = m_timer.now();
+        }
+        if (m_candidate != m_value && m_timer.elapsed(m_since) >= m_ticks) {
+            m_value = m_candidate;
+        }
+        return m_value;
+    }
+
+    bool value() const { return m_value; }
+
+    debounce_t(const duration_t ticks, const bool initial = false)
+        : m_ticks(ticks), m_value(initial), m_candidate(initial) {}
+
+   private:
+    inner::timer_t& m_timer{inner::timer_t::instance()};
+    duration_t      m_ticks;
+    bool            m_value;
+    bool            m_candidate;
+    time_t          m_since{0};
+};
+
+}  // namespace cgx::sch
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace cgx::sch::numa {
+
+struct options_t {
+    // -1 places the storage on the node of the thread constructing it
+    // (first touch); otherwise the pages are bound to the given node.
+    int  node{-1};
+    bool huge_pages{false};
+};
+
+inline int current_node() {
+    unsigned cpu{0};
+    unsigned node{0};
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
+
+template <typename T>
+class local_ptr {
+   public:
+    T*   get() const { return m_ptr; }
+    T&   operator*() const { return *m_ptr; }
+    T*   operator->() const { return m_ptr; }
+    explicit operator bool() const { return m_ptr != nullptr; }
+
+    void reset() {
+        if (m_ptr != nullptr) {
+            m_ptr->~T();
+            munmap(static_cast<void*>(m_ptr), m_size);
+            m_ptr  = nullptr;
+            m_size = 0;
+        }
+    }
+
+    local_ptr() = default;
+    local_ptr(T* ptr, const std::size_t size) : m_ptr(ptr), m_size(size) {}
+    local_ptr(local_ptr&& other) noexcept
+        : m_ptr(std::exchange(other.m_ptr, nullptr)),
+          m_size(std::exchange(other.m_size, 0)) {}
+    local_ptr& operator=(local_ptr&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_ptr  = std::exchange(other.m_ptr, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+    local_ptr(const local_ptr&) = delete;
+    local_ptr& operator=(const local_ptr&) = delete;
+    ~local_ptr() { reset(); }
+
+   private:
+    T*          m_ptr{nullptr};
+    std::size_t m_size{0};
+};
+
+// Maps private pages for a T (e.g. a thread<N>) and constructs it from the
+// calling thread. Call it from the worker that will run the object, after
+// pinning it, so its task array and stats are local to that core.
+template <typename T, typename... Args>
+local_ptr<T> make_local(const options_t& options, Args&&... args) {
+    constexpr std::size_t huge_page = 2 * 1024 * 1024;
+    const std::size_t     page =
+        options.huge_pages ? huge_page
+                           : static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t size = (sizeof(T) + page - 1) / page * page;
+
+    void* addr = MAP_FAILED;
+    if (options.huge_pages) {
+        addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (addr == MAP_FAILED) {
+        addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (addr == MAP_FAILED) {
+            return {};
+        }
+#if defined(MADV_HUGEPAGE)
+        if (options.huge_pages) {
+            madvise(addr, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    if (options.node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+        munmap(addr, size);
+        return {};
+    }
+    if (options.node >= 0) {
+        constexpr int       mpol_bind = 2;
+        const unsigned long mask      = 1UL << options.node;
+        if (syscall(SYS_mbind, addr, size, mpol_bind, &mask,
+                    sizeof(mask) * 8 + 1, 0) != 0) {
+            munmap(addr, size);
+            return {};
+        }
+    }
+
+    return local_ptr<T>(new (addr) T(std::forward<Args>(args)...), size);
+}
+
+}  // namespace cgx::sch::numa
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <dlfcn.h>
+
+#include <array>
+#include <cstddef>
+
+#include "scheduler.hpp"
+
+namespace cgx::sch {
+
+// Replaces task callbacks with functions from shared objects, through
+// scheduler_t::replace_callback(), so a deploy keeps each task's period,
+// phase and stats. A plugin exports
+//
+//   extern "C" bool sch_task_run(void* data);
+//
+// which is called with the task's data(). Libraries are never unloaded: the
+// swapped-out code may still be referenced (posted work, statics, pointers
+// kept by other tasks). dlopen() returns the already loaded image for a path
+// it has seen, so each version must be installed under its own file name.
+//
+// Up to M distinct libraries can be kept; loading more symbols from one
+// already kept does not use another slot. Past that, load() fails with
+// error() set, and a larger M is needed.
+//
+// Link with -ldl on glibc older than 2.34.
+template <std::size_t M = 16>
+class plugin_loader_t {
+   public:
+    using callback_t = bool (*)(void*);
+
+    bool load(const char* task_name, const char* path,
+              const char* symbol = "sch_task_run") {
+        m_error = nullptr;
+        void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr) {
+            m_error = dlerror();
+            return false;
+        }
+        // A library already kept stays loaded through its first reference.
+        const bool is_kept = _is_kept(handle);
+        if (!is_kept && m_count == M) {
+            m_error = "plugin_loader_t: no free handle";
+            dlclose(handle);
+            return false;
+        }
+        dlerror();
+        auto* callback = reinterpret_cast<callback_t>(dlsym(handle, symbol));
+        if (callback == nullptr) {
+            m_error = dlerror();
+            dlclose(handle);
+            return false;
+        }
+        if (!m_scheduler.replace_callback(task_name, callback)) {
+            m_error = "plugin_loader_t: no such task";
+            dlclose(handle);
+            return false;
+        }
+        if (is_kept) {
+            dlclose(handle);
+        } else {
+            m_handles[m_count++] = handle;
+        }
+        return true;
+    }
+
+    // Reason for the last failed load(), or nullptr.
+    const char* error() const { return m_error; }
+    std::size_t size() const { return m_count; }
+
+    plugin_loader_t(scheduler_t& scheduler) : m_scheduler(scheduler) {}
+
+   private:
+    scheduler_t&         m_scheduler;
+    std::array<void*, M> m_handles{};
+    std::size_t          m_count{0};
+    const char*          m_error{nullptr};
+
+    bool _is_kept(const void* handle) const {
+        for (std::size_t i = 0; i < m_count; i++) {
+            if (m_handles[i] == handle) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}  // namespace cgx::sch
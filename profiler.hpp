@@ -0,0 +1,191 @@
+#pragma once
+
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+
+#include "inner.hpp"
+
+namespace cgx::sch {
+
+// Samples are attributed to the task marked as running on the interrupted
+// thread (see inner::dispatch_t). Samples that land outside a task callback
+// are reported as "[scheduler]".
+template <std::size_t N = 128>
+class profiler_t {
+   public:
+    bool start(const std::uint32_t hz = 1000, const bool with_ip = false) {
+        if (hz == 0 || hz > 1000000) {
+            return false;
+        }
+        m_with_ip.store(with_ip, std::memory_order_relaxed);
+
+        struct sigaction sa {};
+        sa.sa_sigaction = &profiler_t::_on_signal;
+        sa.sa_flags     = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        // On a restart the handler is already ours; keep the original one
+        // for stop() to restore.
+        if (sigaction(SIGPROF, &sa, m_is_started ? nullptr : &m_prev_action) !=
+            0) {
+            return false;
+        }
+
+        itimerval timer{};
+        timer.it_interval.tv_sec  = 0;
+        timer.it_interval.tv_usec = static_cast<suseconds_t>(1000000 / hz);
+        timer.it_value            = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            sigaction(SIGPROF, &m_prev_action, nullptr);
+            m_is_started = false;
+            return false;
+        }
+        m_is_started = true;
+        return true;
+    }
+
+    void stop() {
+        if (!m_is_started) {
+            return;
+        }
+        itimerval timer{};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        sigaction(SIGPROF, &m_prev_action, nullptr);
+        m_is_started = false;
+    }
+
+    void reset() {
+        for (auto& s : m_samples) {
+            s.count.store(0, std::memory_order_relaxed);
+        }
+        m_dropped.store(0, std::memory_order_relaxed);
+    }
+
+    // Writes one "task[;0xip] count" line per bucket, the folded stack format
+    // consumed by flamegraph.pl and friends.
+    void dump(std::FILE* out, const char* root = nullptr) const {
+        for (const auto& s : m_samples) {
+            const auto count = s.count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            const auto key = s.name.load(std::memory_order_relaxed);
+            if (root != nullptr) {
+                std::fprintf(out, "%s;", root);
+            }
+            if (key != 0) {
+                char name[9]{};
+                for (std::size_t i = 0; i < 8; i++) {
+                    name[i] = static_cast<char>(key >> (8 * i));
+                }
+                std::fprintf(out, "%s", name);
+            } else {
+                std::fprintf(out, "[scheduler]");
+            }
+            const auto ip = s.ip.load(std::memory_order_relaxed);
+            if (ip != 0) {
+                std::fprintf(out, ";0x%zx", static_cast<std::size_t>(ip));
+            }
+            std::fprintf(out, " %llu\n", static_cast<unsigned long long>(count));
+        }
+    }
+
+    std::uint64_t dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    static profiler_t& instance() {
+        static profiler_t instance;
+        return instance;
+    }
+
+   private:
+    struct sample_t {
+        // The task name's 8 bytes, so a sample never points into a task
+        // that was since killed, moved or destroyed. 0 is "[scheduler]".
+        std::atomic<std::uint64_t>  name{0};
+        std::atomic<std::uintptr_t> ip{0};
+        std::atomic<std::uint8_t>   state{0};
+        std::atomic<std::uint64_t>  count{0};
+    };
+
+    std::array<sample_t, N> m_samples{};
+    std::atomic<std::uint64_t> m_dropped{0};
+    std::atomic<bool>          m_with_ip{false};
+    struct sigaction           m_prev_action {};
+    bool                       m_is_started{false};
+
+    profiler_t() = default;
+    ~profiler_t() = default;
+    profiler_t(const profiler_t&) = delete;
+    profiler_t& operator=(const profiler_t&) = delete;
+
+    static std::uintptr_t _ip(void* context) {
+        const auto* uc = static_cast<const ucontext_t*>(context);
+#if defined(__x86_64__)
+        return static_cast<std::uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+        return static_cast<std::uintptr_t>(uc->uc_mcontext.pc);
+#else
+        (void)uc;
+        return 0;
+#endif
+    }
+
+    static std::uint64_t _key(const char* name) {
+        std::uint64_t key{0};
+        if (name == nullptr) {
+            return key;
+        }
+        for (std::size_t i = 0; i < 8 && name[i] != '\0'; i++) {
+            key |= static_cast<std::uint64_t>(static_cast<unsigned char>(name[i]))
+                   << (8 * i);
+        }
+        return key;
+    }
+
+    // Async-signal-safe: open addressing over a fixed table, no allocation.
+    void _record(const char* task_name, const std::uintptr_t ip) {
+        const auto name = _key(task_name);
+        const auto hash = static_cast<std::size_t>(
+            (name * 0x9e3779b97f4a7c15ull) >> 32 ^ ip);
+        for (std::size_t i = 0; i < N; i++) {
+            auto& s = m_samples[(hash + i) % N];
+            auto state = s.state.load(std::memory_order_acquire);
+            if (state == 0 &&
+                s.state.compare_exchange_strong(state, 1,
+                                                std::memory_order_acquire)) {
+                s.name.store(name, std::memory_order_relaxed);
+                s.ip.store(ip, std::memory_order_relaxed);
+                s.count.fetch_add(1, std::memory_order_relaxed);
+                s.state.store(2, std::memory_order_release);
+                return;
+            }
+            // A slot still being claimed is skipped; duplicate buckets are
+            // summed by flamegraph tooling.
+            if (state == 2 && s.name.load(std::memory_order_relaxed) == name &&
+                s.ip.load(std::memory_order_relaxed) == ip) {
+                s.count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void _on_signal(int, siginfo_t*, void* context) {
+        const auto saved_errno = errno;
+        auto&      self        = instance();
+        const auto ip =
+            self.m_with_ip.load(std::memory_order_relaxed) ? _ip(context) : 0;
+        self._record(inner::dispatch_t::instance().task_name(), ip);
+        errno = saved_errno;
+    }
+};
+
+}  // namespace cgx::sch
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "scheduler.hpp"
+
+namespace cgx::sch {
+
+struct task_descriptor_t {
+    const char*                name;
+    inner::timer_t::duration_t period;
+    std::uint8_t               thread;
+    bool (*callback)();
+};
+
+}  // namespace cgx::sch
+
+// Descriptors placed in the "sch_tasks" section are bounded by the
+// __start_/__stop_ symbols the GNU linkers generate for it. They are weak so
+// that a program with no registered task still links.
+extern "C" {
+extern const cgx::sch::task_descriptor_t __start_sch_tasks[]
+    __attribute__((weak));
+extern const cgx::sch::task_descriptor_t __stop_sch_tasks[]
+    __attribute__((weak));
+}
+
+#define SCH_CONCAT_INNER(a, b) a##b
+#define SCH_CONCAT(a, b) SCH_CONCAT_INNER(a, b)
+
+// fn must be convertible to bool (*)(), e.g. a captureless lambda.
+//
+// An object file from a static library is only linked in if something else
+// references it, so registrations living in a static library need
+// -Wl,--whole-archive (CMake: $<LINK_LIBRARY:WHOLE_ARCHIVE,lib>) or a symbol
+// in the same file that the program uses.
+#define SCH_REGISTER_TASK(name, period, thread, fn)                         \
+    __attribute__((used, section("sch_tasks"), aligned(alignof(            \
+                       cgx::sch::task_descriptor_t)))) static const        \
+        cgx::sch::task_descriptor_t SCH_CONCAT(sch_task_, __COUNTER__) {   \
+        name, period, thread, fn                                            \
+    }
+
+namespace cgx::sch {
+
+// Adds every task registered with SCH_REGISTER_TASK, in link order.
+// Returns the number of tasks that did not fit in their thread, or whose
+// thread index has no thread registered.
+inline std::size_t load_registered_tasks(scheduler_t& scheduler) {
+    const auto& threads = scheduler.threads();
+    std::size_t failed{0};
+    for (const auto* d = __start_sch_tasks; d != __stop_sch_tasks; d++) {
+        if (d->thread >= threads.size() || !threads[d->thread] ||
+            !scheduler.add(task_t(d->name, d->period, d->callback),
+                           d->thread)) {
+            failed++;
+        }
+    }
+    return failed;
+}
+
+}  // namespace cgx::sch
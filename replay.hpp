@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "inner.hpp"
+
+namespace cgx::sch {
+
+// Wraps a now() source and keeps the most recent values it returned,
+// delta-encoded (zigzag varints) in a ring of N bytes. Oldest samples are
+// dropped when the ring is full.
+//
+// Saved layout: u64 first value, u32 sample count, varint deltas.
+//
+// Not copyable, so that it is handed to scheduler_t as std::ref(recorder)
+// rather than silently recording into a copy. Not thread-safe: record from
+// a single scheduler thread, or serialize the now() calls.
+template <std::size_t N = 4096>
+class clock_recorder_t {
+   public:
+    using time_t = inner::timer_t::time_t;
+
+    time_t operator()() {
+        const auto value = m_source();
+        _append(value);
+        return value;
+    }
+
+    std::size_t size() const { return m_count; }
+
+    std::size_t saved_size() const { return header_size + m_used; }
+
+    std::size_t save(std::uint8_t* out, const std::size_t capacity) const {
+        if (capacity < saved_size()) {
+            return 0;
+        }
+        const std::uint32_t count = static_cast<std::uint32_t>(m_count);
+        std::memcpy(out, &m_base, sizeof(m_base));
+        std::memcpy(out + sizeof(m_base), &count, sizeof(count));
+        for (std::size_t i = 0; i < m_used; i++) {
+            out[header_size + i] = m_ring[(m_tail + i) % N];
+        }
+        return saved_size();
+    }
+
+    void reset() {
+        m_count = 0;
+        m_used  = 0;
+        m_tail  = 0;
+    }
+
+    clock_recorder_t(std::function<time_t()> source) : m_source(source) {}
+    clock_recorder_t(const clock_recorder_t&) = delete;
+    clock_recorder_t& operator=(const clock_recorder_t&) = delete;
+
+   private:
+    static constexpr std::size_t header_size =
+        sizeof(time_t) + sizeof(std::uint32_t);
+    static constexpr std::size_t max_varint = 10;
+    static_assert(N >= max_varint, "ring too small for one sample");
+
+    std::function<time_t()>     m_source;
+    std::array<std::uint8_t, N> m_ring{};
+    std::size_t                 m_tail{0};
+    std::size_t                 m_used{0};
+    std::size_t                 m_count{0};
+    time_t                      m_base{0};
+    time_t                      m_last{0};
+
+    void _append(const time_t value) {
+        if (m_count == 0) {
+            m_base  = value;
+            m_last  = value;
+            m_count = 1;
+            return;
+        }
+        const auto delta =
+            static_cast<std::int64_t>(value) - static_cast<std::int64_t>(m_last);
+        auto zigzag = (static_cast<std::uint64_t>(delta) << 1) ^
+                      static_cast<std::uint64_t>(delta >> 63);
+
+        std::array<std::uint8_t, max_varint> bytes{};
+        std::size_t                          len{0};
+        do {
+            bytes[len] = static_cast<std::uint8_t>(zigzag & 0x7f);
+            zigzag >>= 7;
+            if (zigzag != 0) {
+                bytes[len] |= 0x80;
+            }
+            len++;
+        } while (zigzag != 0);
+
+        while (N - m_used < len) {
+            _drop_oldest();
+        }
+        for (std::size_t i = 0; i < len; i++) {
+            m_ring[(m_tail + m_used + i) % N] = bytes[i];
+        }
+        m_used += len;
+        m_last = value;
+        m_count++;
+    }
+
+    void _drop_oldest() {
+        std::uint64_t zigzag{0};
+        unsigned      shift{0};
+        while (true) {
+            const auto byte = m_ring[m_tail];
+            m_tail          = (m_tail + 1) % N;
+            m_used--;
+            zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        const auto delta = static_cast<std::int64_t>(zigzag >> 1) ^
+                           -static_cast<std::int64_t>(zigzag & 1);
+        m_base = static_cast<time_t>(static_cast<std::int64_t>(m_base) + delta);
+        m_count--;
+    }
+};
+
+// Feeds back a sequence saved by clock_recorder_t, one value per call.
+// Once exhausted, keeps returning the last value. Like the recorder, pass
+// it as std::ref(replayer).
+class clock_replayer_t {
+   public:
+    using time_t = inner::timer_t::time_t;
+
+    time_t operator()() {
+        if (m_index >= m_count) {
+            return m_value;
+        }
+        if (m_index > 0) {
+            std::uint64_t zigzag{0};
+            unsigned      shift{0};
+            while (m_pos < m_size) {
+                const auto byte = m_data[m_pos++];
+                zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                shift += 7;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            const auto delta = static_cast<std::int64_t>(zigzag >> 1) ^
+                               -static_cast<std::int64_t>(zigzag & 1);
+            m_value =
+                static_cast<time_t>(static_cast<std::int64_t>(m_value) + delta);
+        }
+        m_index++;
+        return m_value;
+    }
+
+    bool        exhausted() const { return m_index >= m_count; }
+    std::size_t remaining() const { return m_count - m_index; }
+
+    // data must outlive the replayer.
+    clock_replayer_t(const std::uint8_t* data, const std::size_t size)
+        : m_data(data), m_size(size) {
+        constexpr auto header_size = sizeof(time_t) + sizeof(std::uint32_t);
+        if (size < header_size) {
+            return;
+        }
+        std::uint32_t count{0};
+        std::memcpy(&m_value, data, sizeof(m_value));
+        std::memcpy(&count, data + sizeof(m_value), sizeof(count));
+        m_count = count;
+        m_pos   = header_size;
+    }
+    clock_replayer_t(const clock_replayer_t&) = delete;
+    clock_replayer_t& operator=(const clock_replayer_t&) = delete;
+
+   private:
+    const std::uint8_t* m_data;
+    std::size_t         m_size;
+    std::size_t         m_pos{0};
+    std::size_t         m_index{0};
+    std::size_t         m_count{0};
+    time_t              m_value{0};
+};
+
+}  // namespace cgx::sch
@@ -0,0 +1,30 @@
+module;
+
+#include "arena.hpp"
+#include "scheduler.hpp"
+
+// C++20 module interface for the core scheduler. Macros do not cross module
+// boundaries: SCH_SLEEP is spelled [](auto& s) { return s.sleep(ticks); } by
+// importers, and SCH_TICK_HZ / SCH_THREAD_LOCAL must be set on this target.
+export module cgx.scheduler;
+
+export namespace cgx::sch {
+
+using cgx::sch::arena_t;
+using cgx::sch::direction_t;
+using cgx::sch::rate_limiter_t;
+using cgx::sch::scheduler;
+using cgx::sch::scheduler_t;
+using cgx::sch::stage_t;
+using cgx::sch::task_t;
+using cgx::sch::thread;
+using cgx::sch::thread_t;
+
+namespace inner {
+using cgx::sch::inner::dispatch_t;
+using cgx::sch::inner::tick_t;
+using cgx::sch::inner::timer_t;
+using cgx::sch::inner::to_ticks;
+}  // namespace inner
+
+}  // namespace cgx::sch
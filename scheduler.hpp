@@ -1,13 +1,21 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <initializer_list>
-#include <string>
+#include <memory>
+#include <new>
+#include <utility>
 
 #include "inner.hpp"
+#include "limiter.hpp"
+#include "scheduler_fwd.hpp"
 
 namespace cgx::sch {
 
@@ -19,14 +27,91 @@ enum class direction_t {
 
 #define SCH_SLEEP(ticks) [](auto& s) { return s.sleep(ticks); }
 
+template <std::size_t N, bool Enabled>
+class stage_stats_t {
+   public:
+    struct stat_t {
+        // Time spent inside the stage callback per call.
+        inner::stop_watch_t run_time;
+        // Ticks from entering the stage until leaving it, sleeps included.
+        inner::min_max_mean_t<inner::timer_t::time_t> dwell;
+        std::uint32_t                                 stays{0};
+        std::uint32_t                                 nexts{0};
+        std::uint32_t                                 resets{0};
+    };
+
+    auto measure(const std::size_t index) {
+        if (!m_has_entered) {
+            m_entered     = m_timer.now();
+            m_has_entered = true;
+        }
+        return m_stats[index].run_time.measure();
+    }
+
+    void record(const std::size_t index, const direction_t dir) {
+        auto& stat = m_stats[index];
+        switch (dir) {
+            case direction_t::stay:
+                stat.stays++;
+                return;
+            case direction_t::next:
+                stat.nexts++;
+                break;
+            case direction_t::reset:
+                stat.resets++;
+                break;
+        }
+        const auto now = m_timer.now();
+        stat.dwell.add(now - m_entered);
+        m_entered = now;
+    }
+
+    void reset() {
+        for (auto& stat : m_stats) {
+            stat.run_time.reset();
+            stat.dwell.reset();
+            stat.stays  = 0;
+            stat.nexts  = 0;
+            stat.resets = 0;
+        }
+        m_has_entered = false;
+    }
+
+    const stat_t& operator[](const std::size_t index) const {
+        return m_stats[index];
+    }
+
+   private:
+    std::array<stat_t, N>  m_stats{};
+    inner::timer_t&        m_timer{inner::timer_t::instance()};
+    inner::timer_t::time_t m_entered{0};
+    bool                   m_has_entered{false};
+};
+
 template <std::size_t N>
+class stage_stats_t<N, false> {
+   public:
+    struct disposable_t {};
+
+    disposable_t measure(const std::size_t) { return {}; }
+    void         record(const std::size_t, const direction_t) {}
+    void         reset() {}
+};
+
+template <std::size_t N, bool Stats>
 class stage_t {
    public:
     void run() {
         if (!m_stages[m_index]) {
             m_index = 0;
         }
-        const auto dir = m_stages[m_index](*this);
+        const auto  index = m_index;
+        direction_t dir;
+        {
+            [[maybe_unused]] auto _watch = m_stats.measure(index);
+            dir = m_stages[index](*this);
+        }
+        m_stats.record(index, dir);
         switch (dir) {
             case direction_t::next:
                 m_index = (m_index + 1) % N;
@@ -51,16 +136,64 @@ class stage_t {
         return direction_t::stay;
     }
 
+    template <typename Rep, typename Period>
+    direction_t sleep(const std::chrono::duration<Rep, Period> duration) {
+        const auto ticks = inner::to_ticks(duration);
+        return sleep(static_cast<std::size_t>(ticks > 0 ? ticks : 0));
+    }
+
+    // Polls pred with an exponential backoff between min_interval and
+    // max_interval ticks. Goes to the next stage once pred holds, or resets
+    // the sequence after timeout ticks. While backing off, the owning task
+    // is not dispatched until the next poll is due.
+    template <typename P>
+    direction_t wait_until(P&& pred, const std::size_t timeout,
+                           const std::size_t min_interval = 1,
+                           const std::size_t max_interval = 64) {
+        if (!m_is_waiting) {
+            m_is_waiting    = true;
+            m_wait_deadline = m_timer.make_deadline(timeout);
+            m_poll_interval = min_interval > 0 ? min_interval : 1;
+            m_next_poll     = m_timer.now();
+        }
+        if (!m_timer.is_expired(m_next_poll)) {
+            inner::dispatch_t::instance().wake_at(m_next_poll);
+            return direction_t::stay;
+        }
+        if (pred()) {
+            m_is_waiting = false;
+            return direction_t::next;
+        }
+        if (m_timer.is_expired(m_wait_deadline)) {
+            m_is_waiting = false;
+            return direction_t::reset;
+        }
+        m_next_poll     = std::min(m_timer.make_deadline(m_poll_interval),
+                                   m_wait_deadline);
+        m_poll_interval = std::min(m_poll_interval * 2, max_interval);
+        inner::dispatch_t::instance().wake_at(m_next_poll);
+        return direction_t::stay;
+    }
+
+    const auto& stats() const { return m_stats; }
+    void        reset_stats() { m_stats.reset(); }
+
     stage_t(std::array<std::function<direction_t(stage_t&)>, N> stages)
         : m_stages(stages) {}
 
    private:
     std::size_t                                         m_index{0};
     std::array<std::function<direction_t(stage_t&)>, N> m_stages;
+    stage_stats_t<N, Stats>                             m_stats;
 
     inner::timer_t&        m_timer{inner::timer_t::instance()};
     bool                   m_is_sleeping{false};
     inner::timer_t::time_t m_deadline{0};
+
+    bool                   m_is_waiting{false};
+    std::size_t            m_poll_interval{1};
+    inner::timer_t::time_t m_next_poll{0};
+    inner::timer_t::time_t m_wait_deadline{0};
 };
 
 class task_t {
@@ -84,6 +217,25 @@ class task_t {
             return false;
         }
         m_ticks_left = _ticks_left();
+        if (m_wake_tick != 0) {
+            const auto wake_left = -m_timer.elapsed(m_wake_tick);
+            if (wake_left > m_ticks_left) {
+                m_ticks_left = wake_left;
+            }
+        }
+        if (m_is_notified) {
+            const auto notify_left =
+                std::max<duration_t>(-m_timer.elapsed(m_notify_tick), 0);
+            if (notify_left < m_ticks_left) {
+                m_ticks_left = notify_left;
+            }
+        }
+        if (m_limiter != nullptr && m_ticks_left <= 0) {
+            const auto token_left = m_limiter->ticks_until_available();
+            if (token_left > m_ticks_left) {
+                m_ticks_left = token_left;
+            }
+        }
         if (m_ticks_left <= 0) {
             return true;
         }
@@ -98,16 +250,41 @@ class task_t {
             return;
         }
 
+        if (ticks_left() < 0) {
+            m_misses++;
+        }
+        if (m_limiter != nullptr) {
+            m_limiter->try_acquire();
+        }
         m_exec_time.stop();
         m_exec_time.start();
         m_status = status_t::running;
+        const auto now = m_timer.now();
+        // Only a notification that is due is consumed by this run; a later
+        // one stays pending even if the period released the task first.
+        if (m_is_notified && m_notify_tick <= now) {
+            m_notify_tick = m_notify_next;
+            m_is_notified = m_notify_next != 0;
+            m_notify_next = 0;
+        }
         if (m_period_tick >= 0) {
-            m_last_run_tick = m_timer.now();
+            m_last_run_tick = now;
         } else {
-            m_last_run_tick = m_timer.now() - ticks_left();
+            // An early run (notified before the boundary) must not record
+            // a tick that is still in the future.
+            m_last_run_tick =
+                m_next_release != 0 ? std::min(m_next_release, now) : now;
+            m_next_release = _next_release(now);
+        }
+        auto&      dispatch = inner::dispatch_t::instance();
+        auto       _marker  = dispatch.mark(m_name.data());
+        auto       _watch   = m_run_time.measure();
+        if (m_pending.swap.load(std::memory_order_relaxed) != nullptr) {
+            _install_pending();
         }
-        auto       _watch = m_run_time.measure();
-        const auto keep   = m_callback();
+        const auto keep =
+            m_callback ? m_callback() : m_data_callback(m_data);
+        m_wake_tick         = dispatch.wake_tick();
         if (keep) {
             m_status = status_t::paused;
         } else {
@@ -115,10 +292,41 @@ class task_t {
         }
     }
 
+    // Pulls the scheduling state and the callback into cache, for the slot
+    // that will be polled next.
+    void prefetch() const {
+        const auto* first = reinterpret_cast<const char*>(this);
+        const auto* last  = reinterpret_cast<const char*>(&m_data_callback);
+        for (const auto* p = first; p < last; p += 64) {
+            inner::prefetch(p);
+        }
+        inner::prefetch(last - 1);
+    }
+
+    // Makes the task ready at the given tick regardless of its period.
+    // The two earliest distinct pending ticks each get a run; a third one
+    // is folded into the later of those.
+    void notify(const time_t at) {
+        if (!m_is_notified) {
+            m_notify_tick = at;
+            m_is_notified = true;
+            return;
+        }
+        if (at == m_notify_tick) {
+            return;
+        }
+        const auto later = std::max(at, m_notify_tick);
+        m_notify_tick    = std::min(at, m_notify_tick);
+        if (m_notify_next == 0 || later < m_notify_next) {
+            m_notify_next = later;
+        }
+    }
     void invalidate() { m_status = status_t::invalid; }
     void stop() { m_status = status_t::stopped; }
     void start() {
-        m_status = status_t::paused;
+        m_status       = status_t::paused;
+        m_next_release = 0;
+        m_wake_tick    = 0;
         m_run_time.reset();
         m_exec_time.reset();
         m_exec_time.start();
@@ -132,7 +340,64 @@ class task_t {
     const auto& last_run_tick() const { return m_last_run_tick; }
     const auto& run_time() const { return m_run_time.duration(); }
     auto&       run_time() { return m_run_time.duration(); }
-    void        reset_run_time() { m_run_time.reset(); }
+    const auto& misses() const { return m_misses; }
+    void*       data() const { return m_data; }
+    void        set_data(void* data) { m_data = data; }
+    void        set_limiter(rate_limiter_t* limiter) { m_limiter = limiter; }
+    const auto& priority() const { return m_priority; }
+    void        set_priority(const std::uint8_t priority) {
+        m_priority = priority;
+    }
+    // Period, phase and stats are kept.
+    void set_callback(std::function<bool()> callback) {
+        m_callback      = callback;
+        m_data_callback = nullptr;
+    }
+    void set_callback(std::function<bool(void*)> callback) {
+        m_data_callback = callback;
+        m_callback      = nullptr;
+    }
+    // Like set_callback(), but safe from any OS thread while the task is
+    // being dispatched: the callback is handed over and installed by run()
+    // right before the next call. A newer hand-off replaces a pending one,
+    // and copies of the task carry it. Returns false, keeping the current
+    // callback, if the hand-off cannot be allocated.
+    bool replace_callback(std::function<bool()> callback) noexcept {
+        auto* swap = new (std::nothrow) callback_swap_t;
+        if (swap == nullptr) {
+            return false;
+        }
+        swap->callback = std::move(callback);
+        _hand_off(swap);
+        return true;
+    }
+    bool replace_callback(std::function<bool(void*)> callback) noexcept {
+        auto* swap = new (std::nothrow) callback_swap_t;
+        if (swap == nullptr) {
+            return false;
+        }
+        swap->data_callback = std::move(callback);
+        _hand_off(swap);
+        return true;
+    }
+    // Uses the lateness computed by the last is_ready() call, so aging
+    // costs no extra pass over the tasks. Capped at 255: late tasks that
+    // reach the cap tie with the top priority and share round robin.
+    std::size_t effective_priority(const duration_t   aging_ticks,
+                                   const std::uint8_t max_boost) const {
+        if (aging_ticks <= 0 || m_ticks_left >= 0) {
+            return m_priority;
+        }
+        const auto levels = -m_ticks_left / aging_ticks;
+        return std::min<std::size_t>(
+            m_priority + static_cast<std::size_t>(
+                             std::min<duration_t>(levels, max_boost)),
+            255);
+    }
+    void        reset_run_time() {
+        m_run_time.reset();
+        m_misses = 0;
+    }
     duration_t  ticks_left() const {
         if (m_status != status_t::paused) {
             return 0;
@@ -153,82 +418,222 @@ class task_t {
     task_t() = default;
     task_t(const char* name, const duration_t period,
            std::function<bool()> callback)
-        : m_callback(callback),
+        : m_status(status_t::running),
           m_period_tick(period),
-          m_status(status_t::running) {
+          m_callback(callback) {
         const auto len = std::strlen(name);
         memcpy(m_name.data(), name, len > 8 ? 8 : len);
     }
 
+    // The callback receives data(): the thread's inline per-task storage
+    // (see thread<N, UserBytes>) unless a pointer was given with set_data().
+    task_t(const char* name, const duration_t period,
+           std::function<bool(void*)> callback)
+        : m_status(status_t::running),
+          m_period_tick(period),
+          m_data_callback(callback) {
+        const auto len = std::strlen(name);
+        memcpy(m_name.data(), name, len > 8 ? 8 : len);
+    }
+
+    // Constructs the callback closure inside arena. The task is left invalid
+    // (and rejected by thread_t::add()) if the arena is full.
+    template <std::size_t Bytes, typename F>
+    task_t(const char* name, const duration_t period, arena_t<Bytes>& arena,
+           F&& callback)
+        : task_t(name, period, std::function<bool()>{}) {
+        auto ref = arena.bind(std::forward<F>(callback));
+        if (ref) {
+            m_callback = ref;
+        } else {
+            m_status = status_t::invalid;
+        }
+    }
+
+    // Any of the above with the period as a std::chrono duration, converted
+    // with inner::to_ticks() at SCH_TICK_HZ.
+    template <typename Rep, typename Period, typename... Args>
+    task_t(const char* name, const std::chrono::duration<Rep, Period> period,
+           Args&&... args)
+        : task_t(name, inner::to_ticks(period), std::forward<Args>(args)...) {}
+
     task_t& operator=(const task_t& other) {
         m_name          = other.m_name;
         m_callback      = other.m_callback;
+        m_data_callback = other.m_data_callback;
         m_period_tick   = other.m_period_tick;
         m_last_run_tick = other.m_last_run_tick;
+        m_next_release  = other.m_next_release;
+        m_wake_tick     = other.m_wake_tick;
+        m_notify_tick   = other.m_notify_tick;
+        m_notify_next   = other.m_notify_next;
+        m_is_notified   = other.m_is_notified;
         m_status        = other.m_status;
         m_run_time      = other.m_run_time;
         m_exec_time     = other.m_exec_time;
+        m_misses        = other.m_misses;
+        m_data          = other.m_data;
+        m_limiter       = other.m_limiter;
+        m_priority      = other.m_priority;
+        m_pending       = other.m_pending;
         return *this;
     }
     task_t(const task_t& other) {
         m_name          = other.m_name;
         m_callback      = other.m_callback;
+        m_data_callback = other.m_data_callback;
         m_period_tick   = other.m_period_tick;
         m_last_run_tick = other.m_last_run_tick;
+        m_next_release  = other.m_next_release;
+        m_wake_tick     = other.m_wake_tick;
+        m_notify_tick   = other.m_notify_tick;
+        m_notify_next   = other.m_notify_next;
+        m_is_notified   = other.m_is_notified;
         m_status        = other.m_status;
         m_run_time      = other.m_run_time;
         m_exec_time     = other.m_exec_time;
+        m_misses        = other.m_misses;
+        m_data          = other.m_data;
+        m_limiter       = other.m_limiter;
+        m_priority      = other.m_priority;
+        m_pending       = other.m_pending;
     }
     task_t(task_t&&) = default;
 
     ~task_t() = default;
 
    private:
-    std::array<char, 9> m_name{"\0"};
-    std::function<bool()> m_callback{nullptr};
-    duration_t            m_period_tick;
-    duration_t            m_actual_period_tick{};
-    inner::timer_t&       m_timer{inner::timer_t::instance()};
+    struct callback_swap_t {
+        std::function<bool()>      callback;
+        std::function<bool(void*)> data_callback;
+    };
 
+    // Owns the pending hand-off. Copies get their own copy of it, so a
+    // swap requested before thread_t::add() or a migration is not lost.
+    struct pending_t {
+        mutable std::atomic<callback_swap_t*> swap{nullptr};
+
+        pending_t() = default;
+        pending_t(const pending_t& other) : swap(other.clone()) {}
+        pending_t& operator=(const pending_t& other) {
+            delete swap.exchange(other.clone(), std::memory_order_acq_rel);
+            return *this;
+        }
+        ~pending_t() { delete swap.load(std::memory_order_acquire); }
+
+        // Taken out while it is copied, so that a concurrent hand-off or
+        // install cannot free it, then put back unless a newer one came in.
+        callback_swap_t* clone() const {
+            std::unique_ptr<callback_swap_t> taken(
+                swap.exchange(nullptr, std::memory_order_acquire));
+            if (!taken) {
+                return nullptr;
+            }
+            auto*            copy = new callback_swap_t(*taken);
+            callback_swap_t* none{nullptr};
+            if (swap.compare_exchange_strong(none, taken.get(),
+                                             std::memory_order_acq_rel)) {
+                taken.release();
+            }
+            return copy;
+        }
+    };
+
+    // Everything is_ready() reads, then what run() touches first, kept at
+    // the front so that prefetch() covers it in two or three lines.
+    volatile status_t  m_status{status_t::invalid};
+    bool               m_is_notified{false};
+    std::uint8_t       m_priority{0};
+    duration_t         m_period_tick;
     mutable duration_t m_ticks_left{};
-    volatile time_t m_last_run_tick{0};
-    time_t m_exec_ticks{0};
-    mutable time_t m_prev{0};
+    volatile time_t    m_last_run_tick{0};
+    // Aligned tasks (negative period) only: absolute tick of the next
+    // multiple of -period, 0 until the first readiness check.
+    mutable time_t  m_next_release{0};
+    time_t          m_wake_tick{0};
+    time_t          m_notify_tick{0};
+    rate_limiter_t* m_limiter{nullptr};
+    inner::timer_t& m_timer{inner::timer_t::instance()};
+
+    std::array<char, 9>        m_name{"\0"};
+    std::function<bool()>      m_callback{nullptr};
+    std::function<bool(void*)> m_data_callback{nullptr};
+    void*                      m_data{nullptr};
+    duration_t                 m_actual_period_tick{};
+    time_t                     m_exec_ticks{0};
+    time_t                     m_notify_next{0};
+    std::uint32_t              m_misses{0};
 
     inner::stop_watch_t m_run_time;
     inner::stop_watch_t m_exec_time;
+    pending_t           m_pending;
+
+    void _hand_off(callback_swap_t* swap) {
+        delete m_pending.swap.exchange(swap, std::memory_order_acq_rel);
+    }
 
-    volatile status_t m_status{status_t::invalid};
+    void _install_pending() {
+        auto* swap =
+            m_pending.swap.exchange(nullptr, std::memory_order_acquire);
+        if (swap == nullptr) {
+            return;
+        }
+        m_callback      = std::move(swap->callback);
+        m_data_callback = std::move(swap->data_callback);
+        delete swap;
+    }
 
     duration_t _ticks_left() const {
         if (m_period_tick < 0) {
-            if (m_status == status_t::delayed) {
-                return -m_timer.elapsed(m_last_run_tick);
+            if (m_next_release == 0) {
+                m_next_release = _next_release(m_timer.now());
             }
-            //  return -m_period_tick - m_timer.elapsed(m_last_run_tick);
-            auto current = m_timer.now() % -m_period_tick;
-            if (current < m_prev) {
-                m_prev = current;
-                return -m_timer.elapsed(m_last_run_tick);
-            }
-            m_prev = current;
-            return -m_period_tick - current;
+            return -m_timer.elapsed(m_next_release);
         }
         return m_period_tick - m_timer.elapsed(m_last_run_tick);
     }
+
+    time_t _next_release(const time_t now) const {
+        const auto period = static_cast<time_t>(-m_period_tick);
+        return (now / period + 1) * period;
+    }
 };
 
 class thread_t {
    public:
     virtual void run() noexcept = 0;
+    virtual bool try_run() noexcept = 0;
     virtual bool add(const task_t& task) noexcept = 0;
     virtual bool pkill(const char* name) noexcept = 0;
     virtual bool start(const char* name) noexcept = 0;
     virtual bool stop(const char* name) noexcept = 0;
+    virtual bool notify(const char* name, const task_t::time_t at) noexcept = 0;
+    virtual bool set_priority(const char*        name,
+                              const std::uint8_t priority) noexcept = 0;
     virtual void reset_stats() noexcept = 0;
+    virtual bool assign_priorities() noexcept = 0;
+
+    // Swaps the callback of a task: the new one is installed by the owning
+    // thread right before the task's next dispatch (see
+    // task_t::replace_callback()), so this is safe from any OS thread, with
+    // or without lock callbacks. The name lookup takes the thread lock.
+    // False if no task has that name or the hand-off cannot be allocated.
+    virtual bool replace_callback(const char*           name,
+                                  std::function<bool()> callback) noexcept = 0;
+    virtual bool replace_callback(
+        const char* name, std::function<bool(void*)> callback) noexcept = 0;
 
     virtual const inner::stop_watch_t& watch() const noexcept = 0;
 
+    // Queues op to be completed from run() once op->at is reached. op must
+    // stay alive until op->fn has been called. Lock-free.
+    virtual void post(inner::oneshot_t* op) noexcept = 0;
+
+    virtual const task_t* current() const noexcept = 0;
+    virtual std::uint32_t dispatches() const noexcept = 0;
+    virtual void          freeze(const bool frozen = true) noexcept = 0;
+    virtual bool          frozen() const noexcept = 0;
+
     virtual std::size_t size() const noexcept { return 0; }
 
     virtual const task_t* begin() const noexcept = 0;
@@ -248,138 +653,582 @@ class thread_t {
     virtual ~thread_t() = default;
 };
 
-template <std::size_t N>
+template <std::size_t N, std::size_t UserBytes>
 class thread : public thread_t {
    public:
-    void run() noexcept final {
-        if (this->size() == 0) {
-            return;
-        }
+    // Bodies are defined after the class, so that the sizes declared extern
+    // below are compiled once in scheduler_instances.
+    void        run() noexcept final;
+    bool        try_run() noexcept final;
+    std::size_t size() const noexcept final;
+    bool        add(const task_t& task) noexcept final;
+    bool        pkill(const char* name) noexcept final;
+    bool        start(const char* name) noexcept final;
+    bool notify(const char* name, const task_t::time_t at) noexcept final;
+    bool set_priority(const char* name,
+                      const std::uint8_t priority) noexcept final;
+    bool stop(const char* name) noexcept final;
+    void reset_stats() noexcept final;
+    void post(inner::oneshot_t* op) noexcept final;
 
-        this->lock();
+    const inner::stop_watch_t& watch() const noexcept final { return m_watch; }
 
-        auto _watch = m_watch.measure();
-        while (!m_tasks_list[m_index]) {
-            m_index = (m_index + 1) % N;
-        }
-        auto& task = m_tasks_list[m_index];
-        if (task.is_ready()) {
-            task.run();
-        }
-        m_index = (m_index + 1) % N;
+    const task_t* current() const noexcept final { return m_current; }
+    std::uint32_t dispatches() const noexcept final { return m_dispatches; }
+    void freeze(const bool frozen = true) noexcept final { m_frozen = frozen; }
+    bool frozen() const noexcept final { return m_frozen; }
 
-        this->unlock();
+    const task_t* begin() const noexcept final { return m_tasks_list.data(); }
+    task_t* begin() noexcept final { return m_tasks_list.data(); }
+    const task_t* end() const noexcept final {
+        return m_tasks_list.data() + m_tasks_list.size();
+    }
+    task_t* end() noexcept final {
+        return m_tasks_list.data() + m_tasks_list.size();
     }
 
-    std::size_t size() const noexcept final {
-        this->lock();
-        std::size_t count{0};
-        for (const auto& task : m_tasks_list) {
-            if (task) {
-                count++;
-            }
-        }
-        this->unlock();
-        return count;
+    bool replace_callback(const char*           name,
+                          std::function<bool()> callback) noexcept final {
+        return _replace_callback(name, callback);
     }
 
-    bool add(const task_t& task) noexcept final {
-        this->lock();
-        for (auto& t : m_tasks_list) {
-            if (!t) {
-                t = task;
-                this->unlock();
-                return true;
-            }
+    bool replace_callback(
+        const char* name, std::function<bool(void*)> callback) noexcept final {
+        return _replace_callback(name, callback);
+    }
+
+    // Assigns fixed priorities from the tasks' periods and measured
+    // run_time().max(): deadline-monotonic first, Audsley's optimal priority
+    // assignment if that fails the response-time test. Callbacks run to
+    // completion, so the test is non-preemptive: a task can also wait for
+    // one lower-priority (or period 0) job that has already started, and
+    // with that blocking deadline-monotonic is no longer optimal. Deadlines
+    // are the periods (absolute value for aligned tasks); aging is ignored.
+    // Returns whether the set is schedulable; the last ordering tried is
+    // applied either way. Tasks with period 0 get priority 0; past 254
+    // periodic tasks, levels are shared.
+    bool assign_priorities() noexcept final;
+
+    // A task that has been ready for k * ticks_per_level ticks without being
+    // dispatched competes k levels above its priority, up to max_boost and
+    // at most 255. With max_boost at 255 every ready task, however low,
+    // eventually ties with the highest ones and gets a round-robin turn,
+    // even under overload.
+    void set_aging(const task_t::duration_t ticks_per_level,
+                   const std::uint8_t       max_boost = 255);
+
+    // Called at the start of every run()/try_run(), outside the thread lock,
+    // e.g. to drain an external command queue.
+    void set_poll_cb(std::function<void()> poll_cb) { m_poll_cb = poll_cb; }
+
+    void set_lock_unlock_cb(std::function<void()> lock_cb,
+                            std::function<void()> unlock_cb) {
+        m_lock_cb = lock_cb;
+        m_unlock_cb = unlock_cb;
+    }
+
+    void lock() const noexcept final {
+        if (m_lock_cb) {
+            m_lock_cb();
+        }
+    }
+    void unlock() const noexcept final {
+        if (m_unlock_cb) {
+            m_unlock_cb();
         }
-        this->unlock();
-        return false;
     }
 
-    bool pkill(const char* name) noexcept final {
+   private:
+    struct alignas(std::max_align_t) user_data_t {
+        std::array<std::byte, UserBytes> bytes;
+    };
+
+    std::array<task_t, N> m_tasks_list;
+    std::array<user_data_t, (UserBytes > 0 ? N : 0)> m_user_data{};
+    inner::stop_watch_t m_watch;
+    std::size_t m_index{0};
+
+    std::atomic<const task_t*> m_current{nullptr};
+    std::atomic<std::uint32_t> m_dispatches{0};
+    std::atomic<bool>          m_frozen{false};
+
+    std::atomic<inner::oneshot_t*> m_oneshots{nullptr};
+
+    bool               m_prioritized{false};
+    task_t::duration_t m_aging_ticks{0};
+    std::uint8_t       m_max_boost{0};
+
+    std::function<void()> m_lock_cb{nullptr};
+    std::function<void()> m_unlock_cb{nullptr};
+    std::function<void()> m_poll_cb{nullptr};
+
+    template <typename F>
+    bool _replace_callback(const char* name, F& callback) noexcept {
+        if (!callback) {
+            return false;
+        }
         this->lock();
         for (auto& task : m_tasks_list) {
             if (task && std::strncmp(task.name().data(), name, 8) == 0) {
-                task.invalidate();
+                const bool replaced =
+                    task.replace_callback(std::move(callback));
                 this->unlock();
-                return true;
+                return replaced;
             }
         }
         this->unlock();
         return false;
     }
 
-    bool start(const char* name) noexcept final {
-        this->lock();
-        for (auto& task : m_tasks_list) {
-            if (task && std::strncmp(task.name().data(), name, 8) == 0) {
-                task.start();
-                this->unlock();
-                return true;
-            }
-        }
-        this->unlock();
+    task_t::duration_t _deadline(const std::size_t i) const noexcept {
+        const auto period = m_tasks_list[i].period();
+        return period < 0 ? -period : period;
+    }
+
+    task_t::duration_t _cost(const std::size_t i) const noexcept {
+        return static_cast<task_t::duration_t>(
+            m_tasks_list[i].run_time().max());
+    }
+
+    // Non-preemptive response-time analysis (Davis, Burns, Bril and
+    // Lukkien, 2007) of task i under the count tasks in higher, blocked by
+    // a lower-priority job of up to blocking ticks. Every job in the
+    // level-i busy period is checked, since the first is not always the
+    // worst without preemption.
+    bool _is_schedulable(const std::size_t i, const std::size_t* higher,
+                         const std::size_t        count,
+                         const task_t::duration_t blocking) const noexcept;
+
+    // Fills priority levels from the lowest up with any task that meets its
+    // deadline with every unassigned task above it, blocked by the longest
+    // job among those already placed below (and the background tasks).
+    bool _audsley(std::array<std::size_t, N>& order, const std::size_t count,
+                  const task_t::duration_t background) const noexcept;
+
+    // Runs outside the lock so that completions may post again.
+    bool _run_oneshots() noexcept;
+
+    void _dispatch(task_t& task) noexcept {
+        m_current.store(&task, std::memory_order_relaxed);
+        m_dispatches.fetch_add(1, std::memory_order_release);
+        task.run();
+        m_current.store(nullptr, std::memory_order_release);
+    }
+
+    void _advance() noexcept;
+};
+
+template <std::size_t N, std::size_t UserBytes>
+void thread<N, UserBytes>::run() noexcept {
+    if (m_prioritized) {
+        try_run();
+        return;
+    }
+    if (m_poll_cb) {
+        m_poll_cb();
+    }
+    if (m_frozen) {
+        return;
+    }
+    _run_oneshots();
+    if (this->size() == 0) {
+        return;
+    }
+
+    this->lock();
+
+    auto _watch = m_watch.measure();
+    while (!m_tasks_list[m_index]) {
+        m_index = (m_index + 1) % N;
+    }
+    auto& task = m_tasks_list[m_index];
+    if (task.is_ready()) {
+        _dispatch(task);
+    }
+    _advance();
+
+    this->unlock();
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::try_run() noexcept {
+    if (m_poll_cb) {
+        m_poll_cb();
+    }
+    if (m_frozen) {
         return false;
     }
+    const bool ran_oneshots = _run_oneshots();
+    if (this->size() == 0) {
+        return ran_oneshots;
+    }
 
-    bool stop(const char* name) noexcept final {
-        this->lock();
-        for (auto& task : m_tasks_list) {
-            if (task && std::strncmp(task.name().data(), name, 8) == 0) {
-                task.stop();
-                this->unlock();
-                return true;
-            }
+    this->lock();
+
+    auto        _watch = m_watch.measure();
+    task_t*     best{nullptr};
+    std::size_t best_index{0};
+    std::size_t best_priority{0};
+    for (std::size_t i = 0; i < N; i++) {
+        const auto index = (m_index + i) % N;
+        auto&      task  = m_tasks_list[index];
+        if (!task || !task.is_ready()) {
+            continue;
         }
-        this->unlock();
+        const auto priority =
+            task.effective_priority(m_aging_ticks, m_max_boost);
+        if (best == nullptr || priority > best_priority) {
+            best          = &task;
+            best_index    = index;
+            best_priority = priority;
+        }
+        if (!m_prioritized) {
+            break;
+        }
+    }
+    if (best != nullptr) {
+        m_index = best_index;
+        _dispatch(*best);
+        _advance();
+    }
+
+    this->unlock();
+    return best != nullptr || ran_oneshots;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+std::size_t thread<N, UserBytes>::size() const noexcept {
+    this->lock();
+    std::size_t count{0};
+    for (const auto& task : m_tasks_list) {
+        if (task) {
+            count++;
+        }
+    }
+    this->unlock();
+    return count;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::add(const task_t& task) noexcept {
+    if (!task) {
         return false;
     }
+    this->lock();
+    for (std::size_t i = 0; i < N; i++) {
+        auto& t = m_tasks_list[i];
+        if (!t) {
+            t = task;
+            if constexpr (UserBytes > 0) {
+                if (t.data() == nullptr) {
+                    m_user_data[i] = {};
+                    t.set_data(m_user_data[i].bytes.data());
+                }
+            }
+            if (task.priority() != 0) {
+                m_prioritized = true;
+            }
+            this->unlock();
+            return true;
+        }
+    }
+    this->unlock();
+    return false;
+}
 
-    void reset_stats() noexcept final {
-        this->lock();
-        for (auto& task : m_tasks_list) {
-            task.reset_run_time();
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::pkill(const char* name) noexcept {
+    this->lock();
+    for (auto& task : m_tasks_list) {
+        if (task && std::strncmp(task.name().data(), name, 8) == 0) {
+            task.invalidate();
+            this->unlock();
+            return true;
         }
-        m_watch.reset();
-        this->unlock();
     }
+    this->unlock();
+    return false;
+}
 
-    const inner::stop_watch_t& watch() const noexcept final { return m_watch; }
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::start(const char* name) noexcept {
+    this->lock();
+    for (auto& task : m_tasks_list) {
+        if (task && std::strncmp(task.name().data(), name, 8) == 0) {
+            task.start();
+            this->unlock();
+            return true;
+        }
+    }
+    this->unlock();
+    return false;
+}
 
-    const task_t* begin() const noexcept final { return m_tasks_list.data(); }
-    task_t* begin() noexcept final { return m_tasks_list.data(); }
-    const task_t* end() const noexcept final {
-        return m_tasks_list.data() + m_tasks_list.size();
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::notify(const char*          name,
+                                  const task_t::time_t at) noexcept {
+    this->lock();
+    for (auto& task : m_tasks_list) {
+        if (task && std::strncmp(task.name().data(), name, 8) == 0) {
+            task.notify(at);
+            this->unlock();
+            return true;
+        }
     }
-    task_t* end() noexcept final {
-        return m_tasks_list.data() + m_tasks_list.size();
+    this->unlock();
+    return false;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::set_priority(const char*        name,
+                                        const std::uint8_t priority) noexcept {
+    this->lock();
+    for (auto& task : m_tasks_list) {
+        if (task && std::strncmp(task.name().data(), name, 8) == 0) {
+            task.set_priority(priority);
+            m_prioritized = true;
+            this->unlock();
+            return true;
+        }
     }
+    this->unlock();
+    return false;
+}
 
-    void set_lock_unlock_cb(std::function<void()> lock_cb,
-                            std::function<void()> unlock_cb) {
-        m_lock_cb = lock_cb;
-        m_unlock_cb = unlock_cb;
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::stop(const char* name) noexcept {
+    this->lock();
+    for (auto& task : m_tasks_list) {
+        if (task && std::strncmp(task.name().data(), name, 8) == 0) {
+            task.stop();
+            this->unlock();
+            return true;
+        }
     }
+    this->unlock();
+    return false;
+}
 
-    void lock() const noexcept final {
-        if (m_lock_cb) {
-            m_lock_cb();
+template <std::size_t N, std::size_t UserBytes>
+void thread<N, UserBytes>::reset_stats() noexcept {
+    this->lock();
+    for (auto& task : m_tasks_list) {
+        task.reset_run_time();
+    }
+    m_watch.reset();
+    this->unlock();
+}
+
+template <std::size_t N, std::size_t UserBytes>
+void thread<N, UserBytes>::post(inner::oneshot_t* op) noexcept {
+    auto* head = m_oneshots.load(std::memory_order_relaxed);
+    do {
+        op->next = head;
+    } while (!m_oneshots.compare_exchange_weak(
+        head, op, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::assign_priorities() noexcept {
+    this->lock();
+
+    std::array<std::size_t, N> order{};
+    std::size_t                count{0};
+    task_t::duration_t         background{0};
+    for (std::size_t i = 0; i < N; i++) {
+        auto& task = m_tasks_list[i];
+        if (!task) {
+            continue;
+        }
+        if (task.period() == 0) {
+            task.set_priority(0);
+            background = std::max(background, _cost(i));
+            continue;
         }
+        order[count++] = i;
     }
-    void unlock() const noexcept final {
-        if (m_unlock_cb) {
-            m_unlock_cb();
+
+    // Deadline-monotonic order. An insertion sort over the count entries:
+    // std::sort on a sub-range of a 4 or 8 element array trips g++ 12's
+    // -Warray-bounds at -O2.
+    for (std::size_t k = 1; k < count; k++) {
+        const auto  index = order[k];
+        std::size_t j     = k;
+        for (; j > 0 && _deadline(order[j - 1]) > _deadline(index); j--) {
+            order[j] = order[j - 1];
         }
+        order[j] = index;
     }
 
-   private:
-    std::array<task_t, N> m_tasks_list;
-    inner::stop_watch_t m_watch;
-    std::size_t m_index{0};
+    bool               feasible{true};
+    task_t::duration_t blocking{background};
+    for (std::size_t k = count; k-- > 0 && feasible;) {
+        feasible = _is_schedulable(order[k], order.data(), k, blocking);
+        blocking = std::max(blocking, _cost(order[k]));
+    }
+    if (!feasible) {
+        feasible = _audsley(order, count, background);
+    }
 
-    std::function<void()> m_lock_cb{nullptr};
-    std::function<void()> m_unlock_cb{nullptr};
-};
+    for (std::size_t k = 0; k < count; k++) {
+        m_tasks_list[order[k]].set_priority(
+            static_cast<std::uint8_t>(k < 254 ? 255 - k : 1));
+    }
+    m_prioritized = true;
+
+    this->unlock();
+    return feasible;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+void thread<N, UserBytes>::set_aging(const task_t::duration_t ticks_per_level,
+                                     const std::uint8_t       max_boost) {
+    this->lock();
+    m_aging_ticks = ticks_per_level;
+    m_max_boost   = max_boost;
+    if (ticks_per_level > 0) {
+        m_prioritized = true;
+    }
+    this->unlock();
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::_is_schedulable(
+    const std::size_t i, const std::size_t* higher, const std::size_t count,
+    const task_t::duration_t blocking) const noexcept {
+    const auto period = _deadline(i);
+    const auto cost   = _cost(i);
+
+    double utilization = static_cast<double>(cost) / period;
+    for (std::size_t k = 0; k < count; k++) {
+        utilization +=
+            static_cast<double>(_cost(higher[k])) / _deadline(higher[k]);
+    }
+    if (utilization > 1.0) {
+        return false;
+    }
+
+    // Level-i busy period; bounded in case utilization is exactly 1.
+    const auto limit = period * 1024;
+    auto       busy  = blocking + cost;
+    for (std::size_t k = 0; k < count; k++) {
+        busy += _cost(higher[k]);
+    }
+    while (true) {
+        auto next = blocking + (busy + period - 1) / period * cost;
+        for (std::size_t k = 0; k < count; k++) {
+            const auto t = _deadline(higher[k]);
+            next += (busy + t - 1) / t * _cost(higher[k]);
+        }
+        if (next == busy) {
+            break;
+        }
+        if (next > limit) {
+            return false;
+        }
+        busy = next;
+    }
+
+    const auto jobs = std::max<task_t::duration_t>(
+        (busy + period - 1) / period, 1);
+    for (task_t::duration_t q = 0; q < jobs; q++) {
+        // Latest start of job q: higher-priority releases up to and
+        // including that tick go first.
+        auto start = blocking + q * cost;
+        while (true) {
+            auto next = blocking + q * cost;
+            for (std::size_t k = 0; k < count; k++) {
+                next += (start / _deadline(higher[k]) + 1) *
+                        _cost(higher[k]);
+            }
+            if (next - q * period + cost > period) {
+                return false;
+            }
+            if (next == start) {
+                break;
+            }
+            start = next;
+        }
+    }
+    return true;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::_audsley(
+    std::array<std::size_t, N>& order, const std::size_t count,
+    const task_t::duration_t background) const noexcept {
+    std::array<std::size_t, N> unassigned = order;
+    std::array<std::size_t, N> result{};
+    std::array<std::size_t, N> higher{};
+    std::size_t                left     = count;
+    task_t::duration_t         blocking = background;
+
+    for (std::size_t level = count; level-- > 0;) {
+        bool found{false};
+        for (std::size_t u = 0; u < left && !found; u++) {
+            std::size_t h{0};
+            for (std::size_t k = 0; k < left; k++) {
+                if (k != u) {
+                    higher[h++] = unassigned[k];
+                }
+            }
+            if (_is_schedulable(unassigned[u], higher.data(), h,
+                                blocking)) {
+                blocking      = std::max(blocking, _cost(unassigned[u]));
+                result[level] = unassigned[u];
+                unassigned[u] = unassigned[--left];
+                found         = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    order = result;
+    return true;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+bool thread<N, UserBytes>::_run_oneshots() noexcept {
+    if (m_oneshots.load(std::memory_order_relaxed) == nullptr) {
+        return false;
+    }
+    auto* list = m_oneshots.exchange(nullptr, std::memory_order_acquire);
+    inner::oneshot_t* fifo{nullptr};
+    while (list != nullptr) {
+        auto* next = list->next;
+        list->next = fifo;
+        fifo       = list;
+        list       = next;
+    }
+
+    const auto now = inner::timer_t::instance().now();
+    bool       ran{false};
+    while (fifo != nullptr) {
+        auto* op = fifo;
+        fifo     = fifo->next;
+        if (op->at > now) {
+            post(op);
+            continue;
+        }
+        op->fn(op);
+        ran = true;
+    }
+    return ran;
+}
+
+template <std::size_t N, std::size_t UserBytes>
+void thread<N, UserBytes>::_advance() noexcept {
+    m_index = (m_index + 1) % N;
+    for (std::size_t i = 0; i < N && !m_tasks_list[m_index]; i++) {
+        m_index = (m_index + 1) % N;
+    }
+    const auto& next = m_tasks_list[m_index];
+    next.prefetch();
+    if (next.data() != nullptr) {
+        inner::prefetch(next.data());
+    }
+}
 
 class scheduler_t {
    public:
@@ -389,6 +1238,8 @@ class scheduler_t {
     template <typename T>
     using observer_ptr = T*;
 
+    static constexpr std::size_t max_threads = 8;
+
     void run(const uint8_t thread = 0) {
         if (thread >= m_threads.size()) {
             return;
@@ -396,6 +1247,15 @@ class scheduler_t {
         m_threads[thread]->run();
     }
 
+    bool run_prioritized() {
+        for (auto i = m_threads.size(); i-- > 0;) {
+            if (m_threads[i] && m_threads[i]->try_run()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool add(observer_ptr<thread_t> thread) {
         for (auto& t : m_threads) {
             if (!t) {
@@ -439,6 +1299,47 @@ class scheduler_t {
         return false;
     }
 
+    bool notify(const char* name, const duration_t delay = 0) {
+        const auto at = inner::timer_t::instance().make_deadline(
+            static_cast<time_t>(delay > 0 ? delay : 0));
+        for (auto& t : m_threads) {
+            if (t && t->notify(name, at)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool set_priority(const char* name, const std::uint8_t priority) {
+        for (auto& t : m_threads) {
+            if (t && t->set_priority(name, priority)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Hot-swaps a running task's callback; see thread_t::replace_callback().
+    bool replace_callback(const char* name, std::function<bool()> callback) {
+        return _replace_callback(name, callback);
+    }
+
+    bool replace_callback(const char*                name,
+                          std::function<bool(void*)> callback) {
+        return _replace_callback(name, callback);
+    }
+
+    // Per thread; true if every thread's task set is schedulable.
+    bool assign_priorities() {
+        bool feasible{true};
+        for (auto& t : m_threads) {
+            if (t && !t->assign_priorities()) {
+                feasible = false;
+            }
+        }
+        return feasible;
+    }
+
     const auto& threads() const { return m_threads; }
 
     void reset_stats() {
@@ -454,9 +1355,30 @@ class scheduler_t {
     }
 
    private:
-    std::array<observer_ptr<thread_t>, 8> m_threads{nullptr};
+    std::array<observer_ptr<thread_t>, max_threads> m_threads{nullptr};
+
+    template <typename F>
+    bool _replace_callback(const char* name, const F& callback) {
+        for (auto& t : m_threads) {
+            if (t && t->replace_callback(name, callback)) {
+                return true;
+            }
+        }
+        return false;
+    }
 };
 
-extern scheduler_t scheduler;
+// With SCH_EXTERN_TEMPLATES defined, these sizes are instantiated once in
+// the scheduler_instances library instead of in every translation unit.
+#ifdef SCH_EXTERN_TEMPLATES
+#ifdef SCH_INSTANCES_TICK_HZ
+static_assert(SCH_TICK_HZ == SCH_INSTANCES_TICK_HZ,
+              "scheduler_instances was built with another SCH_TICK_HZ");
+#endif
+extern template class thread<4>;
+extern template class thread<8>;
+extern template class thread<16>;
+extern template class thread<32>;
+#endif
 
 }  // namespace cgx::sch
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+// Declarations only, for code that passes thread_t* / task_t& handles around
+// without running or constructing them. Default template arguments live here
+// and are picked up by scheduler.hpp.
+namespace cgx::sch {
+
+enum class direction_t;
+
+class task_t;
+class thread_t;
+class scheduler_t;
+
+template <std::size_t N, bool Stats = false>
+class stage_t;
+
+template <std::size_t N, std::size_t UserBytes = 0>
+class thread;
+
+// Defined in arena.hpp; include it to build tasks from an arena.
+template <std::size_t Bytes>
+class arena_t;
+
+extern scheduler_t scheduler;
+
+}  // namespace cgx::sch
@@ -0,0 +1,10 @@
+#include "scheduler.hpp"
+
+namespace cgx::sch {
+
+template class thread<4>;
+template class thread<8>;
+template class thread<16>;
+template class thread<32>;
+
+}  // namespace cgx::sch
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "scheduler.hpp"
+
+namespace cgx::sch {
+
+// Periodically captures the stats of every task registered in a scheduler_t
+// and appends them to a binary file from a background thread.
+//
+// File layout (native endianness):
+//   header: "SCHS" u16 version
+//   frame:  u64 tick, u16 count, then one column per field:
+//           char name[count][8], u32 run_time_mean[count],
+//           u32 run_time_max[count], u32 actual_period_mean[count],
+//           u32 misses[count], u8 status[count]
+template <std::size_t N = 64>
+class snapshot_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+
+    bool start(const char* path, const duration_t interval,
+               const uint8_t thread = 0) {
+        if (m_file != nullptr || interval <= 0) {
+            return false;
+        }
+        m_file = std::fopen(path, "wb");
+        if (m_file == nullptr) {
+            return false;
+        }
+        const std::uint16_t version = 1;
+        std::fwrite("SCHS", 1, 4, m_file);
+        std::fwrite(&version, sizeof(version), 1, m_file);
+
+        m_running = true;
+        m_writer  = std::thread([this] { _write_loop(); });
+
+        m_is_added = m_scheduler.add(task_t(m_name.data(), interval,
+                                            [this] {
+                                                capture();
+                                                return true;
+                                            }),
+                                     thread);
+        if (!m_is_added) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    void stop() {
+        // Only our own task: another one may share the name.
+        if (m_is_added) {
+            m_scheduler.pkill(m_name.data());
+            m_is_added = false;
+        }
+        if (m_writer.joinable()) {
+            m_running = false;
+            m_cv.notify_one();
+            m_writer.join();
+        }
+        if (m_file != nullptr) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    // Runs on the scheduling core. Never blocks on the writer: if the
+    // previous frame has not been written yet, the new one is dropped.
+    void capture() {
+        auto& frame = m_frames[m_fill];
+        frame.tick  = inner::timer_t::instance().now();
+        frame.count = 0;
+
+        const auto& threads = m_scheduler.threads();
+        for (std::size_t i = 0; i < threads.size(); i++) {
+            auto* t = threads[i];
+            if (!t) {
+                continue;
+            }
+            // The thread whose run() is executing this capture (not
+            // necessarily the one it was added to, see supervisor_t) is
+            // already locked.
+            const auto* current = t->current();
+            const bool  is_own =
+                current != nullptr &&
+                current->name().data() ==
+                    inner::dispatch_t::instance().task_name();
+            if (!is_own) {
+                t->lock();
+            }
+            for (const auto* task = t->begin(); task != t->end(); task++) {
+                if (!*task || frame.count >= N) {
+                    continue;
+                }
+                const auto c = frame.count++;
+                std::memcpy(frame.name[c].data(), task->name().data(), 8);
+                frame.run_time_mean[c] = _u32(task->run_time().mean());
+                frame.run_time_max[c]  = _u32(task->run_time().max());
+                frame.actual_period_mean[c] =
+                    _u32(task->actual_period().mean());
+                frame.misses[c] = task->misses();
+                frame.status[c] = static_cast<std::uint8_t>(task->status());
+            }
+            if (!is_own) {
+                t->unlock();
+            }
+        }
+
+        int expected = -1;
+        if (m_ready.compare_exchange_strong(expected, m_fill)) {
+            m_fill ^= 1;
+            m_cv.notify_one();
+        } else {
+            m_dropped++;
+        }
+    }
+
+    std::uint32_t dropped() const { return m_dropped; }
+
+    snapshot_t(scheduler_t& scheduler, const char* name = "snapshot")
+        : m_scheduler(scheduler) {
+        const auto len = std::strlen(name);
+        std::memcpy(m_name.data(), name, len > 8 ? 8 : len);
+    }
+    ~snapshot_t() { stop(); }
+
+    snapshot_t(const snapshot_t&) = delete;
+    snapshot_t& operator=(const snapshot_t&) = delete;
+
+   private:
+    struct frame_t {
+        time_t                             tick{0};
+        std::uint16_t                      count{0};
+        std::array<std::array<char, 8>, N> name{};
+        std::array<std::uint32_t, N>       run_time_mean{};
+        std::array<std::uint32_t, N>       run_time_max{};
+        std::array<std::uint32_t, N>       actual_period_mean{};
+        std::array<std::uint32_t, N>       misses{};
+        std::array<std::uint8_t, N>        status{};
+    };
+
+    scheduler_t&        m_scheduler;
+    std::array<char, 9> m_name{"\0"};
+    bool                m_is_added{false};
+    std::FILE*          m_file{nullptr};
+
+    std::array<frame_t, 2>     m_frames{};
+    int                        m_fill{0};
+    std::atomic<int>           m_ready{-1};
+    std::atomic<std::uint32_t> m_dropped{0};
+
+    std::atomic<bool>       m_running{false};
+    std::thread             m_writer;
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+
+    static std::uint32_t _u32(const time_t value) {
+        return value > UINT32_MAX ? UINT32_MAX
+                                  : static_cast<std::uint32_t>(value);
+    }
+
+    void _write_frame(const frame_t& frame) {
+        const auto n = frame.count;
+        std::fwrite(&frame.tick, sizeof(frame.tick), 1, m_file);
+        std::fwrite(&frame.count, sizeof(frame.count), 1, m_file);
+        std::fwrite(frame.name.data(), 8, n, m_file);
+        std::fwrite(frame.run_time_mean.data(), 4, n, m_file);
+        std::fwrite(frame.run_time_max.data(), 4, n, m_file);
+        std::fwrite(frame.actual_period_mean.data(), 4, n, m_file);
+        std::fwrite(frame.misses.data(), 4, n, m_file);
+        std::fwrite(frame.status.data(), 1, n, m_file);
+    }
+
+    void _write_loop() {
+        while (true) {
+            {
+                // The producer notifies without taking the mutex, so a
+                // missed wake-up is bounded by the timeout.
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait_for(lock, std::chrono::milliseconds(10), [this] {
+                    return m_ready.load() >= 0 || !m_running;
+                });
+            }
+            const auto ready = m_ready.load();
+            if (ready >= 0) {
+                _write_frame(m_frames[ready]);
+                m_ready = -1;
+            } else if (!m_running) {
+                break;
+            }
+        }
+        std::fflush(m_file);
+    }
+};
+
+}  // namespace cgx::sch
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "scheduler.hpp"
+
+namespace cgx::sch {
+
+// Detects scheduler threads stuck inside a task callback and moves their
+// other tasks to the remaining threads. The stalled thread is frozen until
+// its callback returns; the next check() after that lets it run again,
+// keeping only the task that stalled.
+//
+// check() must be called from outside the supervised threads (a watchdog
+// OS thread, a timer interrupt, ...): a stalled thread never releases its
+// lock, so its slots are read without taking it.
+class supervisor_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+
+    std::size_t check() {
+        const auto  now     = m_timer.now();
+        const auto& threads = m_scheduler.threads();
+        std::size_t moved{0};
+
+        for (std::size_t i = 0; i < threads.size(); i++) {
+            auto* t = threads[i];
+            if (!t) {
+                continue;
+            }
+            auto& w = m_watch[i];
+            if (t->frozen()) {
+                // Threads frozen by someone else are left alone.
+                if (w.stalled != nullptr && t->current() != w.stalled) {
+                    w.stalled    = nullptr;
+                    w.dispatches = t->dispatches();
+                    w.since      = now;
+                    t->freeze(false);
+                }
+                continue;
+            }
+            const auto dispatches = t->dispatches();
+            const auto current    = t->current();
+            if (current == nullptr || dispatches != w.dispatches) {
+                w.dispatches = dispatches;
+                w.since      = now;
+                continue;
+            }
+            if (static_cast<duration_t>(now - w.since) < m_stall_ticks) {
+                continue;
+            }
+
+            t->freeze();
+            w.stalled = current;
+            moved += _migrate(i, current);
+        }
+        return moved;
+    }
+
+    supervisor_t(scheduler_t& scheduler, const duration_t stall_ticks)
+        : m_scheduler(scheduler), m_stall_ticks(stall_ticks) {}
+
+   private:
+    struct watch_t {
+        std::uint32_t dispatches{0};
+        time_t        since{0};
+        const task_t* stalled{nullptr};
+    };
+
+    scheduler_t&    m_scheduler;
+    duration_t      m_stall_ticks;
+    inner::timer_t& m_timer{inner::timer_t::instance()};
+    std::array<watch_t, scheduler_t::max_threads> m_watch{};
+
+    // Tasks are copied with their last run and next release ticks, so they
+    // keep their phase on the new thread.
+    std::size_t _migrate(const std::size_t from, const task_t* stalled) {
+        const auto& threads = m_scheduler.threads();
+        std::size_t moved{0};
+
+        for (auto* task = threads[from]->begin(); task != threads[from]->end();
+             task++) {
+            if (!*task || task == stalled) {
+                continue;
+            }
+            for (std::size_t i = 0; i < threads.size(); i++) {
+                auto* t = threads[i];
+                if (i == from || !t || t->frozen()) {
+                    continue;
+                }
+                if (t->add(*task)) {
+                    task->invalidate();
+                    moved++;
+                    break;
+                }
+            }
+        }
+        return moved;
+    }
+};
+
+}  // namespace cgx::sch
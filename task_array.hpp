@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+
+#include "scheduler.hpp"
+
+namespace cgx::sch {
+
+// M instances of the same periodic job sharing one callback and one task_t
+// slot. Ctx is the user's context, typically a struct of arrays indexed by
+// instance. Each dispatch hands the callback the mask of instances that are
+// due, so it can run them in a single loop.
+template <typename Ctx, std::size_t M>
+class task_array_t {
+   public:
+    using time_t     = inner::timer_t::time_t;
+    using duration_t = inner::timer_t::duration_t;
+    using mask_t     = std::bitset<M>;
+
+    // Returns the number of instances that were due.
+    std::size_t poll() {
+        const auto now = m_timer.now();
+        if (now < m_earliest) {
+            _wake_at(now);
+            return 0;
+        }
+
+        std::array<bool, M> due{};
+        for (std::size_t i = 0; i < M; i++) {
+            due[i] = m_enabled[i] && m_next[i] <= now;
+        }
+
+        mask_t      mask;
+        std::size_t count{0};
+        time_t      earliest{UINT64_MAX};
+        for (std::size_t i = 0; i < M; i++) {
+            if (due[i]) {
+                mask.set(i);
+                count++;
+                m_next[i] += static_cast<time_t>(m_period);
+                if (m_next[i] <= now) {
+                    m_next[i] = now + static_cast<time_t>(m_period);
+                }
+            }
+            if (m_enabled[i] && m_next[i] < earliest) {
+                earliest = m_next[i];
+            }
+        }
+        m_earliest = earliest;
+
+        if (count > 0) {
+            m_callback(m_context, mask);
+        }
+        _wake_at(now);
+        return count;
+    }
+
+    // The first release of instance i is phase ticks after now.
+    void set_phase(const std::size_t i, const duration_t phase) {
+        m_next[i]  = m_timer.now() + static_cast<time_t>(phase);
+        m_earliest = std::min(m_earliest, m_next[i]);
+    }
+
+    void enable(const std::size_t i, const bool enabled = true) {
+        m_enabled[i] = enabled;
+        if (enabled) {
+            m_earliest = std::min(m_earliest, m_next[i]);
+        }
+    }
+
+    // The returned task polls every tick but, through the dispatch wake
+    // hint, is only dispatched when the earliest instance is due. With
+    // every instance disabled it is dispatched once per period, so enable()
+    // takes effect within a period.
+    task_t task(const char* name) {
+        return task_t(name, 1, [this] {
+            poll();
+            return true;
+        });
+    }
+
+    Ctx&       context() { return m_context; }
+    const Ctx& context() const { return m_context; }
+
+    task_array_t(const duration_t period,
+                 std::function<void(Ctx&, const mask_t&)> callback,
+                 Ctx context = {})
+        : m_period(period > 0 ? period : 1),
+          m_callback(callback),
+          m_context(context) {
+        const auto now = m_timer.now();
+        m_next.fill(now);
+        m_enabled.fill(true);
+        m_earliest = now;
+    }
+
+   private:
+    inner::timer_t&                          m_timer{inner::timer_t::instance()};
+    duration_t                               m_period;
+    std::function<void(Ctx&, const mask_t&)> m_callback;
+    Ctx                                      m_context;
+
+    std::array<time_t, M> m_next{};
+    std::array<bool, M>   m_enabled{};
+    time_t                m_earliest{0};
+
+    void _wake_at(const time_t now) const {
+        // UINT64_MAX (nothing enabled) would turn negative in
+        // timer_t::elapsed() and the hint would be ignored.
+        inner::dispatch_t::instance().wake_at(
+            m_earliest != UINT64_MAX ? m_earliest
+                                     : now + static_cast<time_t>(m_period));
+    }
+};
+
+}  // namespace cgx::sch
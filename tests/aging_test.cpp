@@ -0,0 +1,80 @@
+// Priority aging (thread<N>::set_aging()) under overload, driven by a
+// simulated clock that the callbacks advance.
+#include <cstdio>
+
+#include "scheduler.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+struct counts_t {
+    int hi{0};
+    int lo{0};
+};
+
+// hi is due every tick and takes two, so it alone keeps the thread busy.
+static counts_t overload(thread<4>& th, const int polls) {
+    counts_t counts;
+    th.add(task_t("hi", 1, [&] {
+        counts.hi++;
+        now_tick += 2;
+        return true;
+    }));
+    th.add(task_t("lo", 5, [&] {
+        counts.lo++;
+        return true;
+    }));
+    th.set_priority("hi", 255);
+    th.set_priority("lo", 0);
+
+    now_tick = 0;
+    for (int i = 0; i < polls; i++) {
+        now_tick++;
+        th.run();
+    }
+    return counts;
+}
+
+static void test_without_aging_lo_starves() {
+    thread<4> th;
+    const auto counts = overload(th, 10000);
+    CHECK(counts.lo == 0);
+}
+
+static void test_aging_lets_lo_run() {
+    thread<4> th;
+    th.set_aging(1, 255);
+    const auto counts = overload(th, 10000);
+    // lo reaches 255 after 255 late ticks and then ties with hi; it runs
+    // about once every 90 polls.
+    CHECK(counts.lo > 50);
+    CHECK(counts.hi > counts.lo * 50);
+}
+
+static void test_boost_is_capped() {
+    thread<4> th;
+    th.set_aging(1, 100);
+    const auto counts = overload(th, 10000);
+    // Boosted at most to 100, lo never catches up with hi at 255.
+    CHECK(counts.lo == 0);
+}
+
+int main() {
+    test_without_aging_lo_starves();
+    test_aging_lets_lo_run();
+    test_boost_is_capped();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Aligned (negative period) tasks driven by a simulated clock.
+#include <cstdio>
+#include <vector>
+
+#include "scheduler.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+using ticks_t = std::vector<std::uint64_t>;
+
+// Polls th at start, start + step, ... up to end, inclusive.
+static void drive(thread_t& th, const std::uint64_t start,
+                  const std::uint64_t step, const std::uint64_t end) {
+    for (now_tick = start; now_tick <= end; now_tick += step) {
+        th.run();
+    }
+}
+
+static void test_release_at_boundaries() {
+    thread<4> th;
+    ticks_t   runs;
+    th.add(task_t("aligned", -10, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+
+    drive(th, 1, 1, 50);
+    CHECK((runs == ticks_t{10, 20, 30, 40, 50}));
+    CHECK(th.begin()->last_run_tick() == 50);
+    CHECK(th.begin()->misses() == 0);
+}
+
+static void test_skipped_polls() {
+    thread<4> th;
+    ticks_t   runs;
+    ticks_t   releases;
+    th.add(task_t("aligned", -10, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+    // Polls land on 3, 10, 17, 24, ...: every boundary is served at the
+    // first poll after it, none is lost or run twice.
+    for (now_tick = 3; now_tick <= 59; now_tick += 7) {
+        th.run();
+        if (!runs.empty() && runs.back() == now_tick) {
+            const std::uint64_t release = th.begin()->last_run_tick();
+            releases.push_back(release);
+        }
+    }
+    CHECK((runs == ticks_t{10, 24, 31, 45, 52}));
+    // A late dispatch reports the boundary it served, not the poll tick.
+    CHECK((releases == ticks_t{10, 20, 30, 40, 50}));
+}
+
+static void test_restart() {
+    thread<4> th;
+    ticks_t   runs;
+    th.add(task_t("aligned", -10, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+
+    drive(th, 1, 1, 10);
+    CHECK(th.stop("aligned"));
+    drive(th, 11, 1, 34);
+    CHECK(th.start("aligned"));
+    // Stopped across 20 and 30; the next release is the first boundary
+    // after the restart, not the stale 20.
+    drive(th, 35, 1, 50);
+    CHECK((runs == ticks_t{10, 40, 50}));
+    CHECK(th.begin()->last_run_tick() == 50);
+}
+
+static void test_late_dispatch() {
+    thread<4> th;
+    ticks_t   runs;
+    th.add(task_t("aligned", -10, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+
+    drive(th, 0, 1, 10);
+    now_tick = 27;
+    th.run();
+    CHECK(th.begin()->last_run_tick() == 20);
+    // Released again at 30, not 27 + 10.
+    drive(th, 28, 1, 30);
+    CHECK((runs == ticks_t{10, 27, 30}));
+    CHECK(th.begin()->last_run_tick() == 30);
+}
+
+int main() {
+    test_release_at_boundaries();
+    test_skipped_polls();
+    test_restart();
+    test_late_dispatch();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+// ipc::command_queue_t: a producer mapping of the queue pushes commands
+// that the scheduler's poll callback drains, on a simulated clock.
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ipc.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static thread<4> th;
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+using ticks_t = std::vector<std::uint64_t>;
+using queue_t = ipc::command_queue_t<8>;
+
+static void test_push_pop() {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/sch_ipc_test_%d", getpid());
+
+    auto consumer = queue_t::create(name);
+    CHECK(consumer);
+    auto producer = queue_t::open(name);
+    CHECK(producer);
+
+    for (int i = 0; i < 8; i++) {
+        CHECK(producer.start("t"));
+    }
+    // Full: a ninth command is refused rather than overwriting.
+    CHECK(!producer.start("t"));
+
+    ipc::command_t cmd;
+    CHECK(consumer.pop(cmd));
+    CHECK(cmd.type == ipc::command_t::type_t::start);
+    CHECK(std::strcmp(cmd.name, "t") == 0);
+    CHECK(producer.stop("t"));
+
+    int count{0};
+    while (consumer.pop(cmd)) {
+        count++;
+    }
+    CHECK(count == 8);
+    CHECK(cmd.type == ipc::command_t::type_t::stop);
+
+    CHECK(queue_t::unlink(name));
+    CHECK(!queue_t::open(name));
+}
+
+static void test_drain_notifies() {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/sch_ipc_test_%d", getpid());
+
+    auto consumer = queue_t::create(name);
+    auto producer = queue_t::open(name);
+    CHECK(consumer && producer);
+
+    ticks_t runs;
+    th.add(task_t("ev", 1000, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+    th.set_poll_cb([&] { consumer.drain(scheduler); });
+
+    now_tick = 1;
+    CHECK(producer.notify("ev"));
+    CHECK(producer.call_later("ev", 50));
+    // Returns at once: commands are already pending.
+    consumer.wait(1000);
+    for (; now_tick <= 100; now_tick++) {
+        th.run();
+    }
+    CHECK((runs == ticks_t{1, 51}));
+
+    CHECK(producer.stop("ev"));
+    CHECK(producer.notify("ev"));
+    for (; now_tick <= 200; now_tick++) {
+        th.run();
+    }
+    CHECK((runs == ticks_t{1, 51}));
+
+    th.set_poll_cb(nullptr);
+    queue_t::unlink(name);
+}
+
+int main() {
+    scheduler.add(&th);
+    test_push_pop();
+    test_drain_notifies();
+    return failures == 0 ? 0 : 1;
+}
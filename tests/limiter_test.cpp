@@ -0,0 +1,92 @@
+// rate_limiter_t, throttle_t and debounce_t driven by a simulated clock.
+#include <cstdio>
+
+#include "limiter.hpp"
+#include "scheduler.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+static std::uint32_t take_all(rate_limiter_t& limiter) {
+    std::uint32_t count{0};
+    while (limiter.try_acquire()) {
+        count++;
+    }
+    return count;
+}
+
+static void test_full_bucket_does_not_accrue() {
+    now_tick = 0;
+    rate_limiter_t limiter(2, 10);
+    for (; now_tick < 9; now_tick++) {
+        limiter.tokens();
+    }
+
+    // Sitting full from 0 to 9 earns nothing: only the two in the bucket
+    // pass at 9 and 10, not a third one refilled at 10.
+    now_tick = 9;
+    CHECK(take_all(limiter) == 2);
+    now_tick = 10;
+    CHECK(take_all(limiter) == 0);
+    CHECK(limiter.ticks_until_available() == 9);
+
+    now_tick = 18;
+    CHECK(!limiter.try_acquire());
+    now_tick = 19;
+    CHECK(limiter.try_acquire());
+    CHECK(!limiter.try_acquire());
+}
+
+static void test_refill_is_capped() {
+    now_tick = 100;
+    rate_limiter_t limiter(3, 5);
+    CHECK(take_all(limiter) == 3);
+    now_tick = 112;
+    CHECK(limiter.tokens() == 2);
+    now_tick = 1000;
+    CHECK(limiter.tokens() == 3);
+}
+
+static void test_throttle() {
+    now_tick = 0;
+    throttle_t throttle(10);
+    CHECK(throttle());
+    now_tick = 9;
+    CHECK(!throttle());
+    now_tick = 10;
+    CHECK(throttle());
+}
+
+static void test_debounce() {
+    now_tick = 0;
+    debounce_t debounce(5);
+    CHECK(!debounce(true));
+    now_tick = 3;
+    CHECK(!debounce(false));
+    CHECK(!debounce(true));
+    now_tick = 7;
+    CHECK(!debounce(true));
+    now_tick = 8;
+    CHECK(debounce(true));
+}
+
+int main() {
+    test_full_bucket_does_not_accrue();
+    test_refill_is_capped();
+    test_throttle();
+    test_debounce();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+// Notifications (thread_t::notify(), behind scheduler_t::notify() and the
+// ipc queue's notify()/call_later()) driven by a simulated clock.
+#include <cstdio>
+#include <vector>
+
+#include "scheduler.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+using ticks_t = std::vector<std::uint64_t>;
+
+// Polls th at every tick from start to end, inclusive.
+static void drive(thread_t& th, const std::uint64_t start,
+                  const std::uint64_t end) {
+    for (now_tick = start; now_tick <= end; now_tick++) {
+        th.run();
+    }
+}
+
+static void test_delayed_notify_survives_release() {
+    thread<4> th;
+    ticks_t runs;
+    th.add(task_t("t", 100, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+
+    now_tick = 1;
+    CHECK(th.notify("t", 150));
+    // The periodic run at 100 must not swallow the notification for 150.
+    drive(th, 1, 260);
+    CHECK((runs == ticks_t{100, 150, 250}));
+}
+
+static void test_notify_then_call_later() {
+    thread<4> th;
+    ticks_t runs;
+    th.add(task_t("t", 1000, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+
+    now_tick = 1;
+    CHECK(th.notify("t", 1));
+    CHECK(th.notify("t", 51));
+    drive(th, 1, 100);
+    CHECK((runs == ticks_t{1, 51}));
+}
+
+static void test_aligned_notify() {
+    thread<4> th;
+    ticks_t runs;
+    th.add(task_t("t", -100, [&] {
+        runs.push_back(now_tick);
+        return true;
+    }));
+
+    drive(th, 1, 10);
+    CHECK(th.notify("t", 30));
+    drive(th, 11, 30);
+    // The early run records when it ran, not the boundary at 100.
+    CHECK((runs == ticks_t{30}));
+    CHECK(th.begin()->last_run_tick() == 30);
+    drive(th, 31, 200);
+    CHECK((runs == ticks_t{30, 100, 200}));
+    CHECK(th.begin()->last_run_tick() == 200);
+}
+
+int main() {
+    test_delayed_notify_survives_release();
+    test_notify_then_call_later();
+    test_aligned_notify();
+    return failures == 0 ? 0 : 1;
+}
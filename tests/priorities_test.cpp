@@ -0,0 +1,88 @@
+// thread<N>::assign_priorities() on task sets whose run times are measured
+// from a simulated clock that each callback advances by its cost.
+#include <cstdio>
+#include <vector>
+
+#include "scheduler.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+struct spec_t {
+    task_t::duration_t period;
+    std::uint64_t      cost;
+};
+
+using priorities_t = std::vector<std::uint8_t>;
+
+// Adds one task per spec, runs each once so that run_time().max() is its
+// cost, then assigns priorities.
+template <std::size_t N>
+static bool assign(thread<N>& th, const std::vector<spec_t>& specs) {
+    char name[] = "t0";
+    for (const auto& spec : specs) {
+        const auto cost = spec.cost;
+        th.add(task_t(name, spec.period, [cost] {
+            now_tick += cost;
+            return true;
+        }));
+        name[1]++;
+    }
+    now_tick = 1000;
+    for (std::size_t i = 0; i < specs.size(); i++) {
+        th.run();
+    }
+    return th.assign_priorities();
+}
+
+template <std::size_t N>
+static priorities_t priorities(const thread<N>& th) {
+    priorities_t result;
+    for (const auto* task = th.begin(); task != th.end(); task++) {
+        if (*task) {
+            result.push_back(task->priority());
+        }
+    }
+    return result;
+}
+
+static void test_blocking_makes_set_infeasible() {
+    // A alone fits, but once B has started A waits 50 ticks for it and
+    // misses its 10 tick deadline whatever the order.
+    thread<4> th;
+    CHECK(!assign(th, {{10, 1}, {100, 50}}));
+}
+
+static void test_audsley_reorders() {
+    // Deadline-monotonic order (30, 44, 47, 54) fails the non-preemptive
+    // test; lowering the 44 tick task below the others is feasible.
+    thread<8> th;
+    CHECK(assign(th, {{47, 3}, {44, 10}, {30, 14}, {54, 8}}));
+    CHECK((priorities(th) == priorities_t{255, 252, 254, 253}));
+}
+
+static void test_deadline_monotonic() {
+    thread<4> th;
+    CHECK(assign(th, {{100, 5}, {10, 1}, {0, 1}, {-50, 2}}));
+    CHECK((priorities(th) == priorities_t{253, 255, 0, 254}));
+}
+
+int main() {
+    test_blocking_makes_set_infeasible();
+    test_audsley_reorders();
+    test_deadline_monotonic();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+// supervisor_t on a simulated clock. The stalling callback calls check()
+// itself, standing in for a watchdog thread; no lock callbacks are set, so
+// nothing is held while it does.
+#include <cstdio>
+#include <cstring>
+
+#include "supervisor.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+// scheduler_t has no way to remove a thread, so they outlive the tests.
+static thread<4> th1;
+static thread<4> th2;
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+static bool has_task(const thread_t& th, const char* name) {
+    for (const auto* task = th.begin(); task != th.end(); task++) {
+        if (*task && std::strcmp(task->name().data(), name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_migrate_and_recover() {
+    supervisor_t supervisor(scheduler, 100);
+    std::size_t  moved{0};
+    int          stuck_runs{0};
+    int          other_runs{0};
+
+    th1.add(task_t("stuck", 10, [&] {
+        if (stuck_runs++ == 0) {
+            supervisor.check();
+            now_tick += 100;
+            moved = supervisor.check();
+        }
+        return true;
+    }));
+    th1.add(task_t("other", 10, [&] {
+        other_runs++;
+        return true;
+    }));
+
+    now_tick = 10;
+    supervisor.check();
+    th1.run();
+
+    // Migrated while "stuck" was still running.
+    CHECK(moved == 1);
+    CHECK(th1.frozen());
+    CHECK(!has_task(th1, "other"));
+    CHECK(has_task(th2, "other"));
+    CHECK(has_task(th1, "stuck"));
+
+    now_tick += 10;
+    th2.run();
+    CHECK(other_runs == 1);
+
+    // The callback has returned: the next check lets th1 run again.
+    CHECK(supervisor.check() == 0);
+    CHECK(!th1.frozen());
+    now_tick += 10;
+    th1.run();
+    CHECK(stuck_runs == 2);
+}
+
+static void test_manual_freeze_is_kept() {
+    supervisor_t supervisor(scheduler, 100);
+
+    th2.freeze();
+    supervisor.check();
+    now_tick += 1000;
+    supervisor.check();
+    CHECK(th2.frozen());
+}
+
+int main() {
+    scheduler.add(&th1);
+    scheduler.add(&th2);
+    test_migrate_and_recover();
+    test_manual_freeze_is_kept();
+    return failures == 0 ? 0 : 1;
+}
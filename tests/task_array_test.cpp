@@ -0,0 +1,90 @@
+// task_array_t driven by a simulated clock.
+#include <array>
+#include <cstdio>
+
+#include "task_array.hpp"
+
+using namespace cgx::sch;
+
+static std::uint64_t now_tick = 0;
+scheduler_t          cgx::sch::scheduler([] { return now_tick; });
+
+static int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond)) {                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,   \
+                         __LINE__, #cond);                                \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
+
+struct context_t {
+    std::array<int, 8> runs{};
+    int                calls{0};
+};
+
+using array_t = task_array_t<context_t, 8>;
+
+static void count_due(context_t& ctx, const array_t::mask_t& due) {
+    ctx.calls++;
+    for (std::size_t i = 0; i < due.size(); i++) {
+        if (due[i]) {
+            ctx.runs[i]++;
+        }
+    }
+}
+
+static void test_phases_batch_instances() {
+    now_tick = 0;
+    thread<4> th;
+    array_t   array(10, count_due);
+    for (std::size_t i = 0; i < 8; i++) {
+        // From tick 1: a period-1 task is first ready one tick after 0.
+        array.set_phase(i, static_cast<task_t::duration_t>(1 + i % 2));
+    }
+    th.add(array.task("arr"));
+
+    for (now_tick = 0; now_tick < 100; now_tick++) {
+        th.run();
+    }
+    // Two phases per period: one callback per phase, not per instance.
+    CHECK(array.context().calls == 20);
+    for (const auto runs : array.context().runs) {
+        CHECK(runs == 10);
+    }
+    // The wake hint skips the ticks where nothing is due.
+    CHECK(th.dispatches() == 20);
+}
+
+static void test_disabled_instances_stay_idle() {
+    now_tick = 0;
+    thread<4> th;
+    array_t   array(10, count_due);
+    for (std::size_t i = 0; i < 8; i++) {
+        array.enable(i, false);
+    }
+    th.add(array.task("arr"));
+
+    for (now_tick = 0; now_tick < 50; now_tick++) {
+        th.run();
+    }
+    // With nothing enabled the task wakes once per period, not every tick.
+    const auto idle = th.dispatches();
+    CHECK(idle <= 6);
+    CHECK(array.context().calls == 0);
+
+    array.enable(2);
+    for (; now_tick < 100; now_tick++) {
+        th.run();
+    }
+    CHECK(array.context().runs[2] >= 4);
+    CHECK(array.context().runs[3] == 0);
+}
+
+int main() {
+    test_phases_batch_instances();
+    test_disabled_instances_stay_idle();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// Compares the clock.hpp providers: average read cost (read_cost_ns()) and
+// the smallest step observed between consecutive reads, which is never
+// below the read cost.
+//
+//   clock_bench [iterations]
+//
+// Build with SCH_BUILD_TOOLS=ON and CMAKE_BUILD_TYPE=Release.
+#include <cstdio>
+#include <cstdlib>
+
+#include "clock.hpp"
+
+using namespace cgx::sch;
+
+// Nanosecond ticks, so every provider is compared at its native resolution.
+constexpr std::uint64_t hz = 1000000000;
+
+template <typename C>
+double resolution_ns(const C& clock, const std::size_t iterations) {
+    inner::timer_t::time_t best{0};
+    auto                   last = clock();
+    for (std::size_t i = 0; i < iterations; i++) {
+        const auto now = clock();
+        if (now > last && (best == 0 || now - last < best)) {
+            best = now - last;
+        }
+        last = now;
+    }
+    return static_cast<double>(best);
+}
+
+template <typename C>
+void report(const char* name, const C& clock, const std::size_t iterations) {
+    const auto cost       = read_cost_ns(clock, iterations);
+    const auto resolution = resolution_ns(clock, iterations);
+    if (resolution == 0) {
+        std::printf("%-26s %8.2f ns/read   no step seen\n", name,
+                    cost);
+        return;
+    }
+    std::printf("%-26s %8.2f ns/read   resolution %.0f ns\n", name, cost,
+                resolution);
+}
+
+int main(int argc, char** argv) {
+    const std::size_t iterations =
+        argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    report("monotonic_clock_t", monotonic_clock_t<hz>{}, iterations);
+#if defined(CLOCK_MONOTONIC_COARSE)
+    report("monotonic_coarse_clock_t", monotonic_coarse_clock_t<hz>{},
+           iterations);
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    if (tsc_clock_t<hz>::is_invariant()) {
+        report("tsc_clock_t", tsc_clock_t<hz>{}, iterations);
+    } else {
+        std::printf("%-26s skipped, TSC is not invariant\n", "tsc_clock_t");
+    }
+#endif
+    {
+        // Ticker at 1 ms: the resolution is the update period.
+        cached_clock_t<hz> cached(std::chrono::milliseconds(1));
+        report("cached_clock_t (1 ms)", cached.reader(), iterations);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Prints a synthetic task set from workload::generate() as CSV, and
+// optionally runs it in simulated time on a thread<64>.
+//
+//   workload_gen [-n count] [-u utilization] [-p min_period max_period]
+//                [-H] [-b bcet_ratio] [-s seed] [-r ticks]
+//
+//   -H  harmonic periods instead of log-uniform
+//   -r  simulate for ticks and add a late_starts column: runs that began
+//       after their release tick (task_t::misses()), count <= 64
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "workload.hpp"
+
+using namespace cgx::sch;
+
+static workload::sim_clock_t sim;
+scheduler_t                  cgx::sch::scheduler(std::ref(sim));
+
+static int usage() {
+    std::fprintf(stderr,
+                 "usage: workload_gen [-n count] [-u utilization] "
+                 "[-p min_period max_period] [-H] [-b bcet_ratio] "
+                 "[-s seed] [-r ticks]\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    workload::options_t options;
+    std::size_t         count{8};
+    std::uint64_t       ticks{0};
+
+    for (int i = 1; i < argc; i++) {
+        const auto has = [&](const int n) { return i + n < argc; };
+        if (std::strcmp(argv[i], "-n") == 0 && has(1)) {
+            count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-u") == 0 && has(1)) {
+            options.utilization = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "-p") == 0 && has(2)) {
+            options.min_period = std::strtoll(argv[++i], nullptr, 10);
+            options.max_period = std::strtoll(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-H") == 0) {
+            options.periods = workload::period_dist_t::harmonic;
+        } else if (std::strcmp(argv[i], "-b") == 0 && has(1)) {
+            options.bcet_ratio = std::strtod(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "-s") == 0 && has(1)) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-r") == 0 && has(1)) {
+            ticks = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return usage();
+        }
+    }
+    if (count == 0 || options.min_period <= 0 ||
+        options.max_period < options.min_period) {
+        return usage();
+    }
+
+    std::vector<workload::task_spec_t> specs(count);
+    workload::generate(options, specs.data(), count);
+
+    thread<64> th;
+    if (ticks > 0) {
+        if (count > 64) {
+            std::fprintf(stderr, "workload_gen: -r supports up to 64 tasks\n");
+            return 2;
+        }
+        scheduler.add(&th);
+        workload::load(th, specs.data(), count, &sim);
+        const auto dispatches = workload::run_sim(th, sim, ticks);
+        std::fprintf(stderr, "# %llu ticks, %u dispatches\n",
+                     static_cast<unsigned long long>(sim()), dispatches);
+    }
+
+    std::printf("name,period,run_time,utilization,bcet_ratio,seed%s\n",
+                ticks > 0 ? ",late_starts" : "");
+    for (std::size_t i = 0; i < count; i++) {
+        const auto& spec = specs[i];
+        std::printf("w%zu,%lld,%lld,%.6f,%.3f,%llu", i,
+                    static_cast<long long>(spec.period),
+                    static_cast<long long>(spec.run_time), spec.utilization,
+                    spec.bcet_ratio, static_cast<unsigned long long>(spec.seed));
+        if (ticks > 0) {
+            std::printf(",%u", th.begin()[i].misses());
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
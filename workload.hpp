@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "scheduler.hpp"
+
+// Synthetic periodic task sets for comparing scheduling policies.
+namespace cgx::sch::workload {
+
+using time_t     = inner::timer_t::time_t;
+using duration_t = inner::timer_t::duration_t;
+
+enum class period_dist_t {
+    log_uniform,
+    harmonic,
+};
+
+struct options_t {
+    double        utilization{0.5};
+    duration_t    min_period{10};
+    duration_t    max_period{1000};
+    period_dist_t periods{period_dist_t::log_uniform};
+    // Each job runs uniformly between bcet_ratio * run_time and run_time.
+    double        bcet_ratio{1.0};
+    std::uint64_t seed{1};
+};
+
+struct task_spec_t {
+    duration_t    period{0};
+    duration_t    run_time{0};
+    double        utilization{0};
+    double        bcet_ratio{1.0};
+    std::uint64_t seed{0};
+};
+
+// Clock advanced explicitly by the busy callbacks, and by run_sim() while
+// nothing is ready, instead of by wall time. Not copyable: hand it to
+// scheduler_t as std::ref(sim).
+class sim_clock_t {
+   public:
+    time_t operator()() const { return m_now; }
+    void   advance(const duration_t ticks) {
+        m_now += static_cast<time_t>(ticks > 0 ? ticks : 0);
+    }
+
+    sim_clock_t() = default;
+    sim_clock_t(const sim_clock_t&) = delete;
+    sim_clock_t& operator=(const sim_clock_t&) = delete;
+
+   private:
+    time_t m_now{0};
+};
+
+// Bini & Buttazzo's UUniFast: count utilizations summing to total,
+// uniformly distributed over the valid simplex.
+inline void uunifast(const double total, std::mt19937_64& rng, double* u,
+                     const std::size_t count) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double                                 sum = total;
+    for (std::size_t i = 0; i + 1 < count; i++) {
+        const auto next =
+            sum * std::pow(uniform(rng),
+                           1.0 / static_cast<double>(count - i - 1));
+        u[i] = sum - next;
+        sum  = next;
+    }
+    if (count > 0) {
+        u[count - 1] = sum;
+    }
+}
+
+template <std::size_t M>
+std::array<double, M> uunifast(const double total, std::mt19937_64& rng) {
+    std::array<double, M> u{};
+    uunifast(total, rng, u.data(), M);
+    return u;
+}
+
+// Fills specs[0, count); the same set generate<count>() returns.
+inline void generate(const options_t& options, task_spec_t* specs,
+                     const std::size_t count) {
+    std::mt19937_64                        rng(options.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double>                    utilizations(count);
+    uunifast(options.utilization, rng, utilizations.data(), count);
+
+    const auto min_period = static_cast<double>(options.min_period);
+    const auto max_period = static_cast<double>(options.max_period);
+
+    for (std::size_t i = 0; i < count; i++) {
+        double period{min_period};
+        switch (options.periods) {
+            case period_dist_t::log_uniform:
+                period = std::exp(std::log(min_period) +
+                                  uniform(rng) * (std::log(max_period) -
+                                                  std::log(min_period)));
+                break;
+            case period_dist_t::harmonic: {
+                const auto octaves = static_cast<int>(
+                    std::floor(std::log2(max_period / min_period)));
+                std::uniform_int_distribution<int> k(0, octaves);
+                period = min_period * std::ldexp(1.0, k(rng));
+                break;
+            }
+        }
+        auto& spec       = specs[i];
+        spec.period      = static_cast<duration_t>(std::llround(period));
+        spec.utilization = utilizations[i];
+        spec.run_time    = static_cast<duration_t>(
+            std::llround(utilizations[i] * static_cast<double>(spec.period)));
+        spec.bcet_ratio  = options.bcet_ratio;
+        spec.seed        = rng();
+    }
+}
+
+template <std::size_t M>
+std::array<task_spec_t, M> generate(const options_t& options) {
+    std::array<task_spec_t, M> specs{};
+    generate(options, specs.data(), M);
+    return specs;
+}
+
+inline void busy_wait(const duration_t ticks) {
+    auto&      timer = inner::timer_t::instance();
+    const auto start = timer.now();
+    while (timer.elapsed(start) < ticks) {
+    }
+}
+
+// Task that burns its spec'd run time on the scheduler clock, or advances
+// sim when one is given.
+inline task_t make_task(const char* name, const task_spec_t& spec,
+                        sim_clock_t* sim = nullptr) {
+    // xorshift64 keeps the closure a few words, instead of the 2.5 KB of an
+    // mt19937_64, so it does not distort the measured memory layout.
+    std::uint64_t state = spec.seed | 1;
+    return task_t(name, spec.period, [spec, sim, state]() mutable {
+        auto run_time = spec.run_time;
+        if (spec.bcet_ratio < 1.0) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            const auto unit  = static_cast<double>(state >> 11) * 0x1.0p-53;
+            const auto ratio = spec.bcet_ratio + unit * (1.0 - spec.bcet_ratio);
+            run_time         = static_cast<duration_t>(
+                std::llround(ratio * static_cast<double>(run_time)));
+        }
+        if (sim != nullptr) {
+            sim->advance(run_time);
+        } else {
+            busy_wait(run_time);
+        }
+        return true;
+    });
+}
+
+// Adds the whole set to thread as "w<index>" tasks. Returns how many fit.
+inline std::size_t load(thread_t& thread, const task_spec_t* specs,
+                        const std::size_t count, sim_clock_t* sim = nullptr) {
+    std::size_t added{0};
+    for (std::size_t i = 0; i < count; i++) {
+        char name[24]{};
+        std::snprintf(name, sizeof(name), "w%zu", i);
+        if (thread.add(make_task(name, specs[i], sim))) {
+            added++;
+        }
+    }
+    return added;
+}
+
+template <std::size_t M>
+std::size_t load(thread_t& thread, const std::array<task_spec_t, M>& specs,
+                 sim_clock_t* sim = nullptr) {
+    return load(thread, specs.data(), M, sim);
+}
+
+// Runs thread in simulated time until sim reaches until. The busy
+// callbacks advance sim by their run time; while no task is ready it is
+// advanced one tick at a time, which honours every release, notification
+// and wake hint exactly. The scheduler's now() must read sim. Returns the
+// number of task dispatches.
+inline std::uint32_t run_sim(thread_t& thread, sim_clock_t& sim,
+                             const time_t until) {
+    const auto start = thread.dispatches();
+    while (sim() < until) {
+        if (!thread.try_run()) {
+            sim.advance(1);
+        }
+    }
+    return thread.dispatches() - start;
+}
+
+}  // namespace cgx::sch::workload